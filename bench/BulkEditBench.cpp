@@ -0,0 +1,116 @@
+// Headless benchmark for the bulk edit chunk kernels, run over a grid of terrain-like chunks
+// the same way World::applyBulkEdit does: one thread pool task per chunk.
+// Build: g++ -O2 -std=c++17 -pthread -Isource -Ithirdparty/include -Ithirdparty/include/glm -Ithirdparty/include/glad/include bench/BulkEditBench.cpp source/BulkEdit.cpp source/ChunkStorage.cpp source/Block.cpp -o BulkEditBench
+#include "BulkEdit.h"
+#include "ThreadPool.h"
+#include <chrono>
+#include <iostream>
+
+// Chunks in each direction from the origin, (2 * RADIUS + 1)^2 in total
+static constexpr int RADIUS = 10;
+static constexpr int SIDE = 2 * RADIUS + 1;
+
+struct BenchChunk {
+    ChunkBlocks blocks;
+    glm::ivec3 origin;
+};
+
+static std::vector<BenchChunk> chunks;
+
+static BlockType getBlock(glm::ivec3 position) {
+    int cx = (position.x >= 0 ? position.x : position.x - (CHUNK_SIZE - 1)) / CHUNK_SIZE;
+    int cz = (position.z >= 0 ? position.z : position.z - (CHUNK_SIZE - 1)) / CHUNK_SIZE;
+    const BenchChunk& chunk = chunks[(cx + RADIUS) * SIDE + (cz + RADIUS)];
+    return chunk.blocks.get(position.x - chunk.origin.x, position.y, position.z - chunk.origin.z);
+}
+
+static void run(ThreadPool& pool, const char* name, const BulkEdit& edit) {
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::future<size_t>> results;
+    for (BenchChunk& chunk : chunks) {
+        results.push_back(pool.enqueue([&edit, &chunk]() {
+            std::vector<BlockType> dense;
+            chunk.blocks.unpack(dense);
+            size_t changed = BulkEditor::apply(edit, dense, chunk.origin);
+            if (changed)
+                chunk.blocks = ChunkBlocks(dense);
+            return changed;
+        }));
+    }
+    size_t changed = 0;
+    for (auto& result : results)
+        changed += result.get();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    size_t visited = 0;
+    for (const BenchChunk& chunk : chunks)
+        visited += BulkEditor::clipToChunk(edit.box, chunk.origin).volume();
+    std::cout << name << ": " << visited << " voxels, " << changed << " changed in " << seconds * 1000.0
+              << " ms, " << visited / seconds / 1e6 << "M voxels/s" << std::endl;
+}
+
+int main() {
+    std::vector<BlockType> dense(CHUNK_VOLUME);
+    for (int cx = -RADIUS; cx <= RADIUS; cx++) {
+        for (int cz = -RADIUS; cz <= RADIUS; cz++) {
+            for (int x = 0; x < CHUNK_SIZE; x++) {
+                for (int z = 0; z < CHUNK_SIZE; z++) {
+                    int height = 40 + (x * 7 + z * 3 + cx * 5 + cz + 1000) % 30;
+                    for (int y = 0; y < CHUNK_HEIGHT; y++)
+                        dense[blockIndex(x, y, z)] = y < height ? BlockType::SOLID : BlockType::AIR;
+                }
+            }
+            chunks.push_back({ ChunkBlocks(dense), glm::ivec3(cx * CHUNK_SIZE, 0, cz * CHUNK_SIZE) });
+        }
+    }
+
+    ThreadPool pool(std::thread::hardware_concurrency());
+    const int extent = RADIUS * CHUNK_SIZE;
+
+    BulkEdit replace;
+    replace.type = BulkEditType::REPLACE;
+    replace.box = { glm::ivec3(-extent, 0, -extent), glm::ivec3(extent + CHUNK_SIZE - 1, CHUNK_HEIGHT - 1, extent + CHUNK_SIZE - 1) };
+    replace.matchType = BlockType::SOLID;
+    replace.blockType = BlockType::AIR;
+    run(pool, "replace", replace);
+
+    BulkEdit fill;
+    fill.type = BulkEditType::FILL;
+    fill.box = { glm::ivec3(-100, 10, -100), glm::ivec3(100, 60, 100) };
+    fill.blockType = BlockType::SOLID;
+    run(pool, "fill", fill);
+
+    // Copy a box across chunk borders, paste it outside the filled area and compare block for block
+    BlockBox copyBox{ glm::ivec3(-20, 0, -20), glm::ivec3(19, CHUNK_HEIGHT - 1, 19) };
+    BlockRegion region;
+    region.size = copyBox.size();
+    region.blocks.assign(copyBox.volume(), BlockType::AIR);
+    for (const BenchChunk& chunk : chunks) {
+        chunk.blocks.unpack(dense);
+        BulkEditor::copy(dense, chunk.origin, copyBox, region);
+    }
+
+    BulkEdit paste;
+    paste.type = BulkEditType::PASTE;
+    paste.box = { glm::ivec3(120, 0, 120), glm::ivec3(120, 0, 120) + region.size - 1 };
+    paste.region = &region;
+    run(pool, "paste", paste);
+
+    size_t mismatches = 0;
+    for (int y = 0; y < region.size.y; y++) {
+        for (int z = 0; z < region.size.z; z++) {
+            for (int x = 0; x < region.size.x; x++) {
+                glm::ivec3 local(x, y, z);
+                BlockType expected = region.get(local);
+                mismatches += getBlock(copyBox.min + local) != expected;
+                mismatches += getBlock(paste.box.min + local) != expected;
+            }
+        }
+    }
+    if (mismatches) {
+        std::cerr << "copy/paste round trip: " << mismatches << " mismatched blocks" << std::endl;
+        return 1;
+    }
+    std::cout << "copy/paste round trip matched" << std::endl;
+    return 0;
+}
@@ -0,0 +1,113 @@
+// Headless benchmark for chunk reads through ChunkIOQueue, warm and cold. Cold runs drop the
+// region files from the page cache with posix_fadvise first, so it needs a POSIX system.
+// Build: g++ -O2 -std=c++17 -pthread -Isource -Ithirdparty/include -Ithirdparty/include/glm -Ithirdparty/include/glad/include bench/ChunkIOBench.cpp source/ChunkIO.cpp source/RegionStore.cpp source/RegionFile.cpp source/MappedFile.cpp source/ChunkStorage.cpp source/Block.cpp -o ChunkIOBench
+#include "ChunkIO.h"
+#include <fcntl.h>
+#include <unistd.h>
+#include <cmath>
+#include <future>
+#include <iomanip>
+#include <iostream>
+
+// Chunks in each direction from the origin, 64 x 64 chunks spread over 4 regions
+static constexpr int RADIUS = 32;
+static constexpr int CHUNK_COUNT = 4 * RADIUS * RADIUS;
+static constexpr int RUNS = 3;
+
+static const std::filesystem::path SAVE_DIRECTORY = "ChunkIOBench.saves";
+
+static ChunkBlocks makeTerrain(int cx, int cz) {
+    std::vector<BlockType> blocks(CHUNK_VOLUME, BlockType::AIR);
+    for (int x = 0; x < CHUNK_SIZE; x++) {
+        for (int z = 0; z < CHUNK_SIZE; z++) {
+            int height = 60 + static_cast<int>(20 * std::sin((cx * CHUNK_SIZE + x) * 0.05) + 15 * std::cos((cz * CHUNK_SIZE + z) * 0.07));
+            for (int y = 0; y < height; y++)
+                blocks[blockIndex(x, y, z)] = BlockType::SOLID;
+        }
+    }
+    return ChunkBlocks(blocks);
+}
+
+static void dropPageCache() {
+    for (const auto& entry : std::filesystem::directory_iterator(SAVE_DIRECTORY)) {
+        int fd = open(entry.path().c_str(), O_RDONLY);
+        if (fd < 0)
+            continue;
+        fdatasync(fd);
+        posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+        close(fd);
+    }
+}
+
+// Reads every chunk back, returns the number that were missing or, with verify, differ
+static int readAll(const char* name, bool verify) {
+    RegionStore store(SAVE_DIRECTORY);
+    ChunkIOQueue io(store);
+    auto cancelToken = std::make_shared<std::atomic<bool>>(false);
+    std::atomic<int> completed{ 0 };
+    std::atomic<int> bad{ 0 };
+    std::promise<void> finished;
+
+    auto start = std::chrono::steady_clock::now();
+    for (int x = -RADIUS; x < RADIUS; x++) {
+        for (int z = -RADIUS; z < RADIUS; z++) {
+            io.read({ x, z }, cancelToken, [&, x, z](ChunkReadResult&& result) {
+                ChunkBlocks blocks;
+                if (!result.found() || result.error)
+                    ++bad;
+                else if (verify) {
+                    std::vector<BlockType> read, expected;
+                    if (!decodeChunk(result.payload.data(), result.payload.size(), blocks))
+                        ++bad;
+                    else {
+                        blocks.unpack(read);
+                        makeTerrain(x, z).unpack(expected);
+                        bad += read != expected;
+                    }
+                }
+                if (++completed == CHUNK_COUNT)
+                    finished.set_value();
+                });
+        }
+    }
+    finished.get_future().wait();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    ChunkIOStats stats = io.getStats();
+    std::cout << name << ": " << stats.chunksRead << " chunks in " << stats.readBatches << " batches, "
+              << store.getStats().diskReads << " disk reads, " << CHUNK_COUNT / seconds << " chunks/s wall, "
+              << stats.chunksReadPerSecond() << " chunks/s in I/O" << std::endl;
+    return bad;
+}
+
+int main() {
+    std::cout << std::fixed << std::setprecision(0);
+    std::filesystem::remove_all(SAVE_DIRECTORY);
+    {
+        RegionStore store(SAVE_DIRECTORY);
+        ChunkIOQueue io(store);
+        for (int x = -RADIUS; x < RADIUS; x++) {
+            for (int z = -RADIUS; z < RADIUS; z++) {
+                ChunkWrite write{ { x, z }, store.queueSave({ x, z }, makeTerrain(x, z)), {} };
+                encodeChunk(*store.getQueuedSave({ x, z }, write.ticket), write.payload);
+                io.write(std::move(write));
+            }
+        }
+        // The destructor finishes every queued write
+    }
+
+    int bad = readAll("verify", true);
+    for (int run = 0; run < RUNS; run++)
+        bad += readAll("warm", false);
+    for (int run = 0; run < RUNS; run++) {
+        dropPageCache();
+        bad += readAll("cold", false);
+    }
+
+    std::filesystem::remove_all(SAVE_DIRECTORY);
+    if (bad) {
+        std::cerr << bad << " chunks were missing or did not match what was saved" << std::endl;
+        return 1;
+    }
+    return 0;
+}
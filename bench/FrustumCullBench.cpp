@@ -0,0 +1,74 @@
+// Headless benchmark for FrustumCuller::cull, no window or GL context needed.
+// Build: g++ -O2 -mavx -std=c++17 -Isource -Ithirdparty/include/glm bench/FrustumCullBench.cpp source/FrustumCuller.cpp -o FrustumCullBench
+#include "FrustumCuller.h"
+#include <gtc/matrix_transform.hpp>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <vector>
+
+static constexpr int BOX_COUNT = 50000;
+static constexpr int PASSES = 100;
+
+int main() {
+    std::mt19937 rng(3);
+    std::uniform_real_distribution<float> spread(-400.0f, 400.0f);
+    std::uniform_int_distribution<int> height(40, 120);
+
+    FrustumCuller culler;
+    glm::mat4 projection = glm::perspective(glm::radians(75.0f), 16.0f / 9.0f, 0.1f, 320.0f);
+    glm::mat4 view = glm::lookAt(glm::vec3(0, 90, 0), glm::vec3(1, 80, 0.3f), glm::vec3(0, 1, 0));
+    culler.setFrustum(projection * view);
+
+    // Chunk sized boxes snapped to the chunk grid, like World::render submits them
+    std::vector<glm::vec3> mins, maxs;
+    culler.reserve(BOX_COUNT);
+    for (int i = 0; i < BOX_COUNT; i++) {
+        glm::vec3 min(std::floor(spread(rng) / 16.0f) * 16.0f, 0.0f, std::floor(spread(rng) / 16.0f) * 16.0f);
+        glm::vec3 max = min + glm::vec3(16.0f, static_cast<float>(height(rng)), 16.0f);
+        mins.push_back(min);
+        maxs.push_back(max);
+        culler.addBox(min, max);
+    }
+
+    // The batched path must agree with the single box test
+    std::vector<uint32_t> visible;
+    culler.cull(visible);
+    size_t matched = 0;
+    for (int i = 0; i < BOX_COUNT; i++) {
+        if (!culler.isVisible(mins[i], maxs[i]))
+            continue;
+        if (matched >= visible.size() || visible[matched] != static_cast<uint32_t>(i)) {
+            std::cerr << "cull() disagrees with isVisible() at box " << i << std::endl;
+            return 1;
+        }
+        matched++;
+    }
+    if (matched != visible.size()) {
+        std::cerr << "cull() returned " << visible.size() << " boxes, isVisible() " << matched << std::endl;
+        return 1;
+    }
+
+    auto batchedStart = std::chrono::steady_clock::now();
+    for (int pass = 0; pass < PASSES; pass++) {
+        visible.clear();
+        culler.cull(visible);
+    }
+    auto batchedEnd = std::chrono::steady_clock::now();
+
+    size_t singleVisible = 0;
+    auto singleStart = std::chrono::steady_clock::now();
+    for (int pass = 0; pass < PASSES; pass++) {
+        for (int i = 0; i < BOX_COUNT; i++)
+            singleVisible += culler.isVisible(mins[i], maxs[i]);
+    }
+    auto singleEnd = std::chrono::steady_clock::now();
+
+    double batchedUs = std::chrono::duration<double, std::micro>(batchedEnd - batchedStart).count() / PASSES;
+    double singleUs = std::chrono::duration<double, std::micro>(singleEnd - singleStart).count() / PASSES;
+    std::cout << "visible " << visible.size() << "/" << BOX_COUNT << " (" << singleVisible / PASSES << ")\n"
+              << "cull():      " << batchedUs << " us per pass\n"
+              << "isVisible(): " << singleUs << " us per pass" << std::endl;
+    return 0;
+}
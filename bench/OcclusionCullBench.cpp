@@ -0,0 +1,117 @@
+// Headless check and benchmark for OcclusionCuller. Every box reported hidden is sampled at
+// random points, a point inside the frustum with a clear line of sight to the camera means
+// the culler was not conservative and the run fails.
+// Build: g++ -O2 -std=c++17 -Isource -Ithirdparty/include/glm bench/OcclusionCullBench.cpp source/OcclusionCuller.cpp -o OcclusionCullBench
+#include "OcclusionCuller.h"
+#include <gtc/matrix_transform.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <utility>
+#include <vector>
+
+static constexpr int OCCLUDER_COUNT = 40;
+static constexpr int TEST_BOX_COUNT = 20000;
+static constexpr int SAMPLES_PER_BOX = 400;
+static constexpr int PASSES = 100;
+
+struct Box {
+    glm::vec3 min;
+    glm::vec3 max;
+};
+
+// Whether the segment from `from` to just short of `to` passes through the box
+static bool segmentHits(glm::vec3 from, glm::vec3 to, const Box& box) {
+    glm::vec3 direction = to - from;
+    float enter = 0.0f;
+    float exit = 0.999f;
+    for (int axis = 0; axis < 3; axis++) {
+        if (std::abs(direction[axis]) < 1e-9f) {
+            if (from[axis] < box.min[axis] || from[axis] > box.max[axis])
+                return false;
+            continue;
+        }
+        float near = (box.min[axis] - from[axis]) / direction[axis];
+        float far = (box.max[axis] - from[axis]) / direction[axis];
+        if (near > far)
+            std::swap(near, far);
+        enter = std::max(enter, near);
+        exit = std::min(exit, far);
+        if (enter > exit)
+            return false;
+    }
+    return true;
+}
+
+int main() {
+    std::mt19937 rng(9);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+    glm::vec3 camera(0.0f, 70.0f, 0.0f);
+    glm::mat4 projection = glm::perspective(glm::radians(75.0f), 16.0f / 9.0f, 0.1f, 320.0f);
+    glm::mat4 view = glm::lookAt(camera, camera + glm::vec3(1.0f, -0.15f, 0.2f), glm::vec3(0.0f, 1.0f, 0.0f));
+    glm::mat4 projectionView = projection * view;
+
+    // Solid chunk columns in front of the camera, and chunk boxes behind and around them
+    std::vector<Box> occluders;
+    for (int i = 0; i < OCCLUDER_COUNT; i++) {
+        float x = 16.0f * (1 + rng() % 6);
+        float z = 16.0f * (static_cast<int>(rng() % 7) - 3);
+        occluders.push_back({ glm::vec3(x, 0.0f, z), glm::vec3(x + 16.0f, static_cast<float>(40 + rng() % 40), z + 16.0f) });
+    }
+    std::vector<Box> tests;
+    for (int i = 0; i < TEST_BOX_COUNT; i++) {
+        float x = 16.0f * (2 + rng() % 20);
+        float z = 16.0f * (static_cast<int>(rng() % 30) - 15);
+        tests.push_back({ glm::vec3(x, 0.0f, z), glm::vec3(x + 16.0f, static_cast<float>(10 + rng() % 100), z + 16.0f) });
+    }
+
+    OcclusionCuller culler;
+    auto rasterStart = std::chrono::steady_clock::now();
+    for (int pass = 0; pass < PASSES; pass++) {
+        culler.begin(projectionView);
+        for (const Box& occluder : occluders)
+            culler.addOccluder(occluder.min, occluder.max);
+        culler.finish();
+    }
+    auto rasterEnd = std::chrono::steady_clock::now();
+
+    int hidden = 0;
+    auto testStart = std::chrono::steady_clock::now();
+    for (const Box& box : tests)
+        hidden += !culler.isVisible(box.min, box.max);
+    auto testEnd = std::chrono::steady_clock::now();
+
+    // A hidden box must not have a single sample point the camera can see
+    int wronglyHidden = 0;
+    for (const Box& box : tests) {
+        if (culler.isVisible(box.min, box.max))
+            continue;
+        for (int sample = 0; sample < SAMPLES_PER_BOX; sample++) {
+            glm::vec3 point = box.min + (box.max - box.min) * glm::vec3(unit(rng), unit(rng), unit(rng));
+            glm::vec4 clip = projectionView * glm::vec4(point, 1.0f);
+            if (clip.w < 0.1f || std::abs(clip.x) > clip.w || std::abs(clip.y) > clip.w)
+                continue;
+
+            bool blocked = std::any_of(occluders.begin(), occluders.end(), [&](const Box& occluder) { return segmentHits(camera, point, occluder); });
+            if (!blocked) {
+                ++wronglyHidden;
+                break;
+            }
+        }
+    }
+
+    double rasterUs = std::chrono::duration<double, std::micro>(rasterEnd - rasterStart).count() / PASSES;
+    double testUs = std::chrono::duration<double, std::micro>(testEnd - testStart).count() / TEST_BOX_COUNT;
+    std::cout << "hidden " << hidden << "/" << TEST_BOX_COUNT << "\n"
+              << OCCLUDER_COUNT << " occluders + pyramid: " << rasterUs << " us\n"
+              << "isVisible: " << testUs << " us per box" << std::endl;
+
+    if (wronglyHidden) {
+        std::cerr << wronglyHidden << " boxes reported hidden have visible points" << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,49 @@
+// Headless benchmark for OffsetAllocator: a million random allocate/free calls sized like chunk
+// meshes in faces, then one defragment of the result.
+// Build: g++ -O2 -std=c++17 -Isource bench/OffsetAllocatorBench.cpp source/OffsetAllocator.cpp -o OffsetAllocatorBench
+#include "OffsetAllocator.h"
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <vector>
+
+static constexpr int OPERATIONS = 1000000;
+static constexpr size_t MIN_LIVE = 2000;
+
+int main() {
+    std::mt19937 rng(1);
+    OffsetAllocator allocator(1u << 24);
+    std::vector<uint32_t> offsets;
+    size_t failedAllocations = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    for (int operation = 0; operation < OPERATIONS; ++operation) {
+        if (offsets.size() < MIN_LIVE || rng() % 2) {
+            uint32_t offset = allocator.allocate(100 + rng() % 6000);
+            if (offset != OffsetAllocator::INVALID_OFFSET)
+                offsets.push_back(offset);
+            else
+                ++failedAllocations;
+        }
+        else {
+            size_t index = rng() % offsets.size();
+            allocator.free(offsets[index]);
+            offsets[index] = offsets.back();
+            offsets.pop_back();
+        }
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    AllocatorStats stats = allocator.getStats();
+    double milliseconds = std::chrono::duration<double, std::milli>(end - start).count();
+    std::cout << OPERATIONS << " operations in " << milliseconds << " ms, "
+              << milliseconds * 1e6 / OPERATIONS << " ns each, " << failedAllocations << " failed\n"
+              << stats.allocationCount << " live, " << stats.freeBlockCount << " free blocks, fragmentation "
+              << stats.fragmentation() << std::endl;
+
+    auto defragmentStart = std::chrono::steady_clock::now();
+    std::vector<AllocatorMove> moves = allocator.defragment();
+    double defragmentMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - defragmentStart).count();
+    std::cout << "defragment: " << moves.size() << " moves in " << defragmentMs << " ms" << std::endl;
+    return 0;
+}
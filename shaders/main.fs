@@ -7,22 +7,29 @@ in vec3 Normal;
 in vec2 TexCoord;
 in float visibility;
 
-uniform vec3 objectColor;
-uniform vec3 lightColor;
-uniform vec3 lightPos;
-uniform vec3 fogColor;
+// Per-frame data, FrameUniforms on the C++ side
+layout(std140, binding = 0) uniform FrameData {
+    mat4 projection;
+    mat4 view;
+    mat4 model;
+    vec4 cameraPos;
+    vec4 fogColor;
+    vec4 lightPos;
+    vec4 lightColor;
+    vec4 objectColor;
+};
 
 void main()
 {
     float ambientStrength = 0.5;
-    vec3 ambient = ambientStrength * lightColor;
+    vec3 ambient = ambientStrength * lightColor.rgb;
 
-    vec3 lightDir = normalize(lightPos - FragPos);
+    vec3 lightDir = normalize(lightPos.xyz - FragPos);
     float diff = max(dot(Normal, lightDir), 0.0);
-    vec3 diffuse = diff * lightColor;
+    vec3 diffuse = diff * lightColor.rgb;
 
-    vec3 litColor = (ambient + diffuse) * objectColor;
+    vec3 litColor = (ambient + diffuse) * objectColor.rgb;
 
-    vec3 finalColor = mix(fogColor, litColor, visibility);
+    vec3 finalColor = mix(fogColor.rgb, litColor, visibility);
     FragColor = vec4(finalColor, 1.0);
 }
@@ -1,43 +1,32 @@
 #version 430 core
 
-struct CompactBlockVertex {
-    uint position;
-    uint normal;
-    uint texCoord;
+// One record per quad, see PackedFace in Block.h
+struct PackedFace {
+    uint geometry;
+    uint material;
 };
 
-vec3 unpackPosition(uint data, vec3 chunkOffset) {
-    float x = float(data & 0x3FF);
-    float y = float((data >> 10) & 0x3FF);
-    float z = float((data >> 20) & 0x3FF);
-    return vec3(x, y, z) + chunkOffset;
-}
-
-vec3 unpackNormal(uint data) {
-    float scale = 1023.0;
-    return normalize(vec3(float((data & 0x3FF)) / scale - 0.5,
-                          float(((data >> 10) & 0x3FF)) / scale - 0.5,
-                          float(((data >> 20) & 0x3FF)) / scale - 0.5));
-}
-
-vec2 unpackTexCoord(uint data) {
-    return vec2(unpackHalf2x16(data).x, unpackHalf2x16(data).y);
-}
-
-layout(std430, binding = 0) buffer VertexBuffer {
-    CompactBlockVertex vertices[];
+layout(std430, binding = 0) buffer FaceBuffer {
+    PackedFace faces[];
 };
 
-layout(std430, binding = 1) buffer IndexBuffer {
-    uint indices[];
+// Per-frame data, FrameUniforms on the C++ side
+layout(std140, binding = 0) uniform FrameData {
+    mat4 projection;
+    mat4 view;
+    mat4 model;
+    vec4 cameraPos;
+    vec4 fogColor;
+    vec4 lightPos;
+    vec4 lightColor;
+    vec4 objectColor;
 };
 
-uniform mat4 projection;
-uniform mat4 view;
-uniform mat4 model;
-uniform vec3 cameraPos;
+// Per draw: chunk origin
+layout(location = 0) in ivec3 chunkOrigin;
 
-uniform vec3 chunkOffset;
+// FACE_CORNERS, FACE_UVS, FACE_NORMALS, FACE_UV_AXES and QUAD_CORNERS are generated from
+// the tables in Block.h and inserted after #version when the shader is loaded
 
 out vec3 FragPos;
 out vec2 TexCoord;
@@ -48,20 +37,26 @@ const float fogDensity = 0.005;
 const float fogGradient = 1.5;
 
 void main() {
-    uint index = indices[gl_VertexID];
-    uint packedPosition = vertices[index].position;
+    // Draws start at faceOffset * 6, so this indexes the shared face buffer directly
+    uint geometry = faces[gl_VertexID / 6].geometry;
+    int corner = QUAD_CORNERS[gl_VertexID % 6];
+
+    vec3 blockPos = vec3(geometry & 0xFu, (geometry >> 4) & 0x7Fu, (geometry >> 11) & 0xFu);
+    int face = int((geometry >> 15) & 0x7u);
+    vec2 quadSize = vec2(((geometry >> 18) & 0xFu) + 1u, ((geometry >> 22) & 0x7Fu) + 1u);
 
-    vec3 pos = unpackPosition(packedPosition, chunkOffset);
+    vec3 size = vec3(1.0);
+    size[FACE_UV_AXES[face].x] = quadSize.x;
+    size[FACE_UV_AXES[face].y] = quadSize.y;
 
-    vec3 normal = unpackNormal(vertices[index].normal);
-    vec2 texCoord = unpackTexCoord(vertices[index].texCoord);
+    vec3 pos = vec3(chunkOrigin) + blockPos + FACE_CORNERS[face * 4 + corner] * size;
 
     FragPos = pos;
-    Normal = normal;
-    TexCoord = texCoord;
+    Normal = FACE_NORMALS[face];
+    TexCoord = FACE_UVS[face * 4 + corner] * quadSize;
 
     // Calculate fog visibility
-    float distance = length(pos - cameraPos);
+    float distance = length(pos - cameraPos.xyz);
     float fogFactor = distance * fogDensity;
     visibility = exp(-pow(fogFactor, fogGradient));
     visibility = clamp(visibility, 0.0, 1.0);
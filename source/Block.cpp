@@ -1,45 +1,77 @@
 #include "Block.h"
+#include "ChunkStorage.h"
+#include <sstream>
 
+static_assert(CHUNK_SIZE <= 16 && CHUNK_HEIGHT <= 128, "PackedFace has 4 bits for x/z and 7 bits for y");
+static_assert(sizeof(PackedFace) == 8, "PackedFace must match the std430 layout in main.vs");
 
-uint32_t packPosition(glm::vec3 pos) {
-    uint32_t x = static_cast<uint32_t>(pos.x) & 0x3FF;
-    uint32_t y = static_cast<uint32_t>(pos.y) & 0x3FF;
-    uint32_t z = static_cast<uint32_t>(pos.z) & 0x3FF;
-    return (z << 20) | (y << 10) | (x);
+PackedFace packFace(glm::ivec3 pos, Face face, glm::ivec2 size, BlockType type) {
+    PackedFace packed;
+    packed.geometry = (static_cast<uint32_t>(pos.x) & 0xF)
+        | (static_cast<uint32_t>(pos.y) & 0x7F) << 4
+        | (static_cast<uint32_t>(pos.z) & 0xF) << 11
+        | (static_cast<uint32_t>(face) & 0x7) << 15
+        | (static_cast<uint32_t>(size.x - 1) & 0xF) << 18
+        | (static_cast<uint32_t>(size.y - 1) & 0x7F) << 22;
+    packed.material = static_cast<uint32_t>(type);
+    return packed;
 }
 
-uint32_t packNormal(glm::vec3 normal) {
-    normal = glm::normalize(normal);
-    glm::vec3 n = (normal * 0.5f + 0.5f) * 1023.0f;
-    uint32_t nx = static_cast<uint32_t>(round(n.x)) & 0x3FF;
-    uint32_t ny = static_cast<uint32_t>(round(n.y)) & 0x3FF;
-    uint32_t nz = static_cast<uint32_t>(round(n.z)) & 0x3FF;
-    return (nz << 20) | (ny << 10) | (nx);
+void AddFaceToMesh(std::vector<PackedFace>& faces, glm::vec3 pos, Face face, BlockType type, glm::vec3 size)
+{
+    const int8_t* uvAxes = FACE_UV_AXES[static_cast<int>(face)];
+    glm::ivec2 uvSize(static_cast<int>(size[uvAxes[0]]), static_cast<int>(size[uvAxes[1]]));
+    faces.push_back(packFace(glm::ivec3(pos), face, uvSize, type));
 }
 
-uint32_t packTexCoord(glm::vec2 texCoord) {
-    uint16_t u = glm::packHalf1x16(texCoord.x);
-    uint16_t v = glm::packHalf1x16(texCoord.y);
-    return (static_cast<uint32_t>(u) << 16) | static_cast<uint32_t>(v);
+void unpackFace(const PackedFace& face, FaceVertex corners[4])
+{
+    uint32_t geometry = face.geometry;
+    glm::vec3 blockPos(geometry & 0xF, (geometry >> 4) & 0x7F, (geometry >> 11) & 0xF);
+    int faceIndex = (geometry >> 15) & 0x7;
+    glm::vec2 quadSize(((geometry >> 18) & 0xF) + 1, ((geometry >> 22) & 0x7F) + 1);
+
+    const int8_t* uvAxes = FACE_UV_AXES[faceIndex];
+    glm::vec3 size(1.0f);
+    size[uvAxes[0]] = quadSize.x;
+    size[uvAxes[1]] = quadSize.y;
+
+    glm::vec3 normal(0.0f);
+    normal[FACE_AXIS[faceIndex]] = FACE_SIGN[faceIndex];
+
+    for (int i = 0; i < 4; i++) {
+        const float* corner = FACE_CORNERS[faceIndex * 4 + i];
+        const float* uv = FACE_UVS[faceIndex * 4 + i];
+        corners[i].position = blockPos + glm::vec3(corner[0], corner[1], corner[2]) * size;
+        corners[i].normal = normal;
+        corners[i].texCoord = glm::vec2(uv[0], uv[1]) * quadSize;
+    }
 }
 
-void AddFaceToMesh(std::vector<CompactBlockVertex>& compactVertices, std::vector<GLuint>& indices, glm::vec3 pos, const GLfloat* faceData, GLuint& indexOffset)
+std::string faceTablesGLSL()
 {
-    for (int i = 0; i < 4; i++) {
-        CompactBlockVertex vertex;
-        vertex.position = packPosition(pos + glm::vec3(faceData[i * 8 + 0],
-            faceData[i * 8 + 1],
-            faceData[i * 8 + 2]));
-        vertex.normal = packNormal(glm::vec3(faceData[i * 8 + 3],
-            faceData[i * 8 + 4],
-            faceData[i * 8 + 5]));
-        vertex.texCoord = packTexCoord(glm::vec2(faceData[i * 8 + 6],
-            faceData[i * 8 + 7]));
-        compactVertices.push_back(vertex);
+    std::ostringstream glsl;
+    glsl << "const vec3 FACE_CORNERS[24] = vec3[](\n";
+    for (int i = 0; i < 24; i++)
+        glsl << "    vec3(" << FACE_CORNERS[i][0] << ", " << FACE_CORNERS[i][1] << ", " << FACE_CORNERS[i][2] << ")" << (i < 23 ? ",\n" : "\n);\n");
+
+    glsl << "const vec2 FACE_UVS[24] = vec2[](\n";
+    for (int i = 0; i < 24; i++)
+        glsl << "    vec2(" << FACE_UVS[i][0] << ", " << FACE_UVS[i][1] << ")" << (i < 23 ? ",\n" : "\n);\n");
+
+    glsl << "const vec3 FACE_NORMALS[6] = vec3[](\n";
+    for (int i = 0; i < 6; i++) {
+        int normal[3] = { 0, 0, 0 };
+        normal[FACE_AXIS[i]] = FACE_SIGN[i];
+        glsl << "    vec3(" << normal[0] << ", " << normal[1] << ", " << normal[2] << ")" << (i < 5 ? ",\n" : "\n);\n");
     }
 
-    indices.insert(indices.end(), { indexOffset, indexOffset + 1,
-                                      indexOffset + 2, indexOffset,
-                                      indexOffset + 2, indexOffset + 3 });
-    indexOffset += 4;
+    glsl << "const ivec2 FACE_UV_AXES[6] = ivec2[](\n";
+    for (int i = 0; i < 6; i++)
+        glsl << "    ivec2(" << int(FACE_UV_AXES[i][0]) << ", " << int(FACE_UV_AXES[i][1]) << ")" << (i < 5 ? ",\n" : "\n);\n");
+
+    glsl << "const int QUAD_CORNERS[6] = int[](";
+    for (int i = 0; i < 6; i++)
+        glsl << int(QUAD_CORNERS[i]) << (i < 5 ? ", " : ");\n");
+    return glsl.str();
 }
@@ -3,7 +3,7 @@
 #include <glad/glad.h>
 #include <glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
-#include <gtc/packing.hpp>
+#include <string>
 #include <vector>
 
 const GLfloat LEFT_FACE[] = {
@@ -48,20 +48,82 @@ const GLfloat BACK_FACE[] = {
     -0.5f,  0.5f, -0.5f,  0.0f,  0.0f, -1.0f,  0.0f, 1.0f
 };
 
-enum class BlockType {
-    AIR, SOLID
+const GLfloat* const FACE_DATA[] = {
+    LEFT_FACE, RIGHT_FACE, TOP_FACE, BOTTOM_FACE, FRONT_FACE, BACK_FACE
 };
 
-struct CompactBlockVertex {
-    uint32_t position;
-    uint32_t normal;
-    uint32_t texCoord;
+// Order matches FACE_DATA
+enum class Face : uint8_t {
+    LEFT, RIGHT, TOP, BOTTOM, FRONT, BACK
 };
 
-void AddFaceToMesh(std::vector<CompactBlockVertex>& compactVertices,
-    std::vector<GLuint>& indices,
+// Axis the face points along (0 = x, 1 = y, 2 = z) and its sign
+constexpr int8_t FACE_AXIS[] = { 0, 0, 1, 1, 2, 2 };
+constexpr int8_t FACE_SIGN[] = { -1, 1, 1, -1, 1, -1 };
+
+// Axes the u and v texture coordinates run along for each face
+constexpr int8_t FACE_UV_AXES[][2] = { {2, 1}, {2, 1}, {0, 2}, {0, 2}, {0, 1}, {0, 1} };
+
+// Unit quad corners and texture coordinates, 4 per face in Face order
+constexpr float FACE_CORNERS[24][3] = {
+    {0, 0, 0}, {0, 1, 0}, {0, 1, 1}, {0, 0, 1},     // left
+    {1, 0, 0}, {1, 0, 1}, {1, 1, 1}, {1, 1, 0},     // right
+    {0, 1, 0}, {1, 1, 0}, {1, 1, 1}, {0, 1, 1},     // top
+    {0, 0, 0}, {0, 0, 1}, {1, 0, 1}, {1, 0, 0},     // bottom
+    {0, 0, 1}, {0, 1, 1}, {1, 1, 1}, {1, 0, 1},     // front
+    {0, 0, 0}, {1, 0, 0}, {1, 1, 0}, {0, 1, 0}      // back
+};
+
+constexpr float FACE_UVS[24][2] = {
+    {0, 0}, {0, 1}, {1, 1}, {1, 0},
+    {0, 0}, {1, 0}, {1, 1}, {0, 1},
+    {0, 0}, {1, 0}, {1, 1}, {0, 1},
+    {0, 0}, {0, 1}, {1, 1}, {1, 0},
+    {0, 0}, {0, 1}, {1, 1}, {1, 0},
+    {0, 0}, {1, 0}, {1, 1}, {0, 1}
+};
+
+// Two triangles per quad, as indices into the face's corners
+constexpr int8_t QUAD_CORNERS[6] = { 0, 1, 2, 0, 2, 3 };
+
+enum class BlockType : uint16_t {
+    AIR, SOLID,
+    COUNT       // Number of block types, not a block. Keep last.
+};
+
+// One quad of a chunk mesh. The vertex shader expands it into two triangles from
+// gl_VertexID, so there are no shared vertices and no index buffer.
+//   geometry: x (4 bits) | y (7) | z (4) | face (3) | width - 1 (4) | height - 1 (7)
+//   material: block type
+// Position is the quad's minimum block in chunk-local coordinates. Width and height
+// run along the face's FACE_UV_AXES.
+struct PackedFace {
+    uint32_t geometry;
+    uint32_t material;
+};
+
+PackedFace packFace(glm::ivec3 pos, Face face, glm::ivec2 size, BlockType type);
+
+// One corner of a quad as main.vs produces it, in chunk-local coordinates
+struct FaceVertex {
+    glm::vec3 position;
+    glm::vec3 normal;
+    glm::vec2 texCoord;
+};
+
+// CPU mirror of the vertex shader's decoding, corners in the order QUAD_CORNERS indexes them
+void unpackFace(const PackedFace& face, FaceVertex corners[4]);
+
+// GLSL constants for FACE_CORNERS, FACE_UVS, FACE_NORMALS, FACE_UV_AXES and QUAD_CORNERS.
+// main.vs does not declare them itself, they are injected from these tables when it is loaded.
+std::string faceTablesGLSL();
+
+// pos is the minimum corner of the quad and size its extent in blocks (1 along the
+// face axis), so merged quads can span several blocks.
+void AddFaceToMesh(std::vector<PackedFace>& faces,
     glm::vec3 pos,
-    const GLfloat* faceData,
-    GLuint& indexOffset);
+    Face face,
+    BlockType type,
+    glm::vec3 size = glm::vec3(1.0f));
 
 class Block {};
@@ -0,0 +1,69 @@
+#include "BulkEdit.h"
+#include <algorithm>
+
+// Calls fn(block, localPosition) for every block of `local`, one x row at a time
+template<class F>
+static size_t forEachBlock(std::vector<BlockType>& blocks, const BlockBox& local, F&& fn)
+{
+    size_t changed = 0;
+    for (int32_t y = local.min.y; y <= local.max.y; ++y) {
+        for (int32_t z = local.min.z; z <= local.max.z; ++z) {
+            BlockType* row = &blocks[blockIndex(0, y, z)];
+            for (int32_t x = local.min.x; x <= local.max.x; ++x) {
+                BlockType next = fn(row[x], glm::ivec3(x, y, z));
+                changed += next != row[x];
+                row[x] = next;
+            }
+        }
+    }
+    return changed;
+}
+
+BlockBox BulkEditor::clipToChunk(const BlockBox& box, glm::ivec3 chunkOrigin)
+{
+    BlockBox chunkBox{ chunkOrigin, chunkOrigin + glm::ivec3(CHUNK_SIZE - 1, CHUNK_HEIGHT - 1, CHUNK_SIZE - 1) };
+    BlockBox clipped = box.intersect(chunkBox);
+    return { clipped.min - chunkOrigin, clipped.max - chunkOrigin };
+}
+
+size_t BulkEditor::apply(const BulkEdit& edit, std::vector<BlockType>& blocks, glm::ivec3 chunkOrigin)
+{
+    BlockBox local = clipToChunk(edit.box, chunkOrigin);
+    if (local.empty())
+        return 0;
+
+    switch (edit.type) {
+    case BulkEditType::FILL:
+        return forEachBlock(blocks, local, [&edit](BlockType, glm::ivec3) { return edit.blockType; });
+
+    case BulkEditType::REPLACE:
+        return forEachBlock(blocks, local, [&edit](BlockType block, glm::ivec3) {
+            return block == edit.matchType ? edit.blockType : block;
+            });
+
+    case BulkEditType::PASTE: {
+        // Local chunk position to region position
+        glm::ivec3 toRegion = chunkOrigin - edit.box.min;
+        return forEachBlock(blocks, local, [&edit, toRegion](BlockType, glm::ivec3 position) {
+            return edit.region->get(position + toRegion);
+            });
+    }
+    }
+    return 0;
+}
+
+void BulkEditor::copy(const std::vector<BlockType>& blocks, glm::ivec3 chunkOrigin, const BlockBox& box, BlockRegion& region)
+{
+    BlockBox local = clipToChunk(box, chunkOrigin);
+    if (local.empty())
+        return;
+
+    glm::ivec3 toRegion = chunkOrigin - box.min;
+    for (int32_t y = local.min.y; y <= local.max.y; ++y) {
+        for (int32_t z = local.min.z; z <= local.max.z; ++z) {
+            const BlockType* row = &blocks[blockIndex(0, y, z)];
+            BlockType* out = &region.blocks[region.index(glm::ivec3(local.min.x, y, z) + toRegion)];
+            std::copy(row + local.min.x, row + local.max.x + 1, out);
+        }
+    }
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "Block.h"
+#include "ChunkStorage.h"
+#include <vector>
+
+// Box of world block coordinates, both corners inclusive
+struct BlockBox {
+    glm::ivec3 min{ 0 };
+    glm::ivec3 max{ -1 };
+
+    bool empty() const { return max.x < min.x || max.y < min.y || max.z < min.z; }
+    glm::ivec3 size() const { return max - min + 1; }
+    size_t volume() const
+    {
+        if (empty())
+            return 0;
+        glm::ivec3 extent = size();
+        return static_cast<size_t>(extent.x) * extent.y * extent.z;
+    }
+
+    BlockBox intersect(const BlockBox& other) const { return { glm::max(min, other.min), glm::min(max, other.max) }; }
+};
+
+// Blocks copied out of the world, y-major like chunk data: x + size.x * (z + size.z * y)
+struct BlockRegion {
+    glm::ivec3 size{ 0 };
+    std::vector<BlockType> blocks;
+
+    BlockType get(glm::ivec3 position) const { return blocks[index(position)]; }
+    size_t index(glm::ivec3 position) const
+    {
+        return static_cast<size_t>(position.x) + static_cast<size_t>(size.x) * (position.z + static_cast<size_t>(size.z) * position.y);
+    }
+};
+
+enum class BulkEditType : uint8_t {
+    FILL,       // Every block in the box becomes blockType
+    REPLACE,    // Blocks of matchType in the box become blockType
+    PASTE       // The region is written with its minimum corner at box.min
+};
+
+struct BulkEdit {
+    BulkEditType type = BulkEditType::FILL;
+    BlockBox box;
+    BlockType blockType = BlockType::AIR;
+    BlockType matchType = BlockType::AIR;
+    const BlockRegion* region = nullptr;
+};
+
+// Applies box edits to one chunk at a time. Chunks share nothing, so a World runs one
+// call per touched chunk in parallel.
+class BulkEditor {
+public:
+    // Part of the chunk at chunkOrigin the box covers, in chunk-local coordinates
+    static BlockBox clipToChunk(const BlockBox& box, glm::ivec3 chunkOrigin);
+
+    // Applies the part of the edit inside the chunk to its dense y-major blocks and
+    // returns how many blocks changed
+    static size_t apply(const BulkEdit& edit, std::vector<BlockType>& blocks, glm::ivec3 chunkOrigin);
+
+    // Copies the part of `box` inside the chunk into the region covering `box`
+    static void copy(const std::vector<BlockType>& blocks, glm::ivec3 chunkOrigin, const BlockBox& box, BlockRegion& region);
+};
@@ -1,73 +1,59 @@
 #include "Chunk.h"
 #include "World.h"
 
-Chunk::Chunk(glm::vec3 worldPos, std::pair<int, int> chunkCoord, World* worldRef) : VAO(0), indexSSBO(0), 
-                                                            vertexSSBO(0), coord(chunkCoord), offset(worldPos), world(worldRef) 
+Chunk::Chunk(glm::vec3 worldPos, std::pair<int, int> chunkCoord, World* worldRef) : coord(chunkCoord), offset(worldPos), world(worldRef)
 {
-    glGenVertexArrays(1, &dummyVAO);
+    sectionConnectivity.fill(SectionVisibility::ALL_CONNECTED);
 }
 
 Chunk::~Chunk() {}
 
 void Chunk::cleanupOpenGLResources()
 {
-    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, 0);
-    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, 0);
-    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
-
-    // Delete SSBOs
-    if (glIsBuffer(vertexSSBO)) {
-        glDeleteBuffers(1, &vertexSSBO);
-        vertexSSBO = 0;
-    }
-    if (glIsBuffer(indexSSBO)) {
-        glDeleteBuffers(1, &indexSSBO);
-        indexSSBO = 0;
-    }
-
-    // Delete VAO
-    if (glIsVertexArray(dummyVAO)) {
-        glDeleteVertexArrays(1, &dummyVAO);
-        dummyVAO = 0;
-    }
+    // Hand the slice back to the shared buffers
+    world->getMeshArena().release(meshHandle);
+    meshHandle = MeshArena::INVALID_HANDLE;
+    readyToRender = false;
 }
 
-void Chunk::uploadMeshToGPU() {
-    glGenBuffers(1, &vertexSSBO);
-    glBindBuffer(GL_SHADER_STORAGE_BUFFER, vertexSSBO);
-    glBufferData(GL_SHADER_STORAGE_BUFFER, compactVertices.size() * sizeof(CompactBlockVertex), compactVertices.data(), GL_STATIC_DRAW);
-    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, vertexSSBO);
-
-    glGenBuffers(1, &indexSSBO);
-    glBindBuffer(GL_SHADER_STORAGE_BUFFER, indexSSBO);
-    glBufferData(GL_SHADER_STORAGE_BUFFER, indices.size() * sizeof(GLuint), indices.data(), GL_STATIC_DRAW);
-    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, indexSSBO);
-
-    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
-}
-
-void Chunk::render(shader& shader) {
-    if (!readyToRender)
-        return;
-
-    shader.use();
-    glBindVertexArray(dummyVAO);
-    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, vertexSSBO);
-    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, indexSSBO);
-    glDrawArrays(GL_TRIANGLES, 0, static_cast<GLsizei>(indices.size()));
-    glBindVertexArray(0);
-}
-
-inline BlockType& Chunk::getBlock(int16_t x, int16_t y, int16_t z)
+std::vector<BlockType> Chunk::getBorderLayer(NeighbourSide side) const
 {
-    return chunkData[x + CHUNK_SIZE * (y + CHUNK_HEIGHT * z)];
+    std::vector<BlockType> layer;
+    if (chunkData.empty())
+        return layer;
+
+    layer.resize(CHUNK_SIZE * CHUNK_HEIGHT);
+    for (int32_t y = 0; y < CHUNK_HEIGHT; ++y) {
+        for (int32_t t = 0; t < CHUNK_SIZE; ++t) {
+            BlockType type;
+            switch (side) {
+            case NeighbourSide::NEG_X: type = chunkData.get(0, y, t); break;
+            case NeighbourSide::POS_X: type = chunkData.get(CHUNK_SIZE - 1, y, t); break;
+            case NeighbourSide::NEG_Z: type = chunkData.get(t, y, 0); break;
+            default:                   type = chunkData.get(t, y, CHUNK_SIZE - 1); break;
+            }
+            layer[t + CHUNK_SIZE * y] = type;
+        }
+    }
+    return layer;
 }
 
-void Chunk::uploadMeshFromThread(const ChunkMeshData& mesh)
+void Chunk::uploadMeshFromThread(ChunkMeshData&& mesh)
 {
-    compactVertices = mesh.vertices;
-    indices = mesh.indices;
+    if (!mesh.blocks.empty())
+        chunkData = std::move(mesh.blocks);
 
-    uploadMeshToGPU();
+    if (mesh.revision < uploadedRevision)
+        return;
+    uploadedRevision = mesh.revision;
+
+    // Remeshes reuse the handle, the arena frees the old slice before placing the new one
+    meshHandle = world->getMeshArena().upload(meshHandle, mesh.faces);
+    faceCount = mesh.faces.size();
+    minHeight = mesh.minHeight;
+    maxHeight = mesh.maxHeight;
+    solidMinHeight = mesh.solidMinHeight;
+    solidMaxHeight = mesh.solidMaxHeight;
+    sectionConnectivity = mesh.sectionConnectivity;
     readyToRender = true;
 }
@@ -1,50 +1,142 @@
 #pragma once
 
 #include "Block.h"
+#include "ChunkStorage.h"
+#include "MeshArena.h"
+#include "SectionVisibility.h"
 #include "shader.h"
 #include "FastNoiseLite.h"
 #include <vector>
-
-constexpr int32_t CHUNK_SIZE = 16;                      // Number of blocks along x, z
-constexpr int32_t CHUNK_HEIGHT = 128;                   // Number of blocks along y
+#include <chrono>
+#include <memory>
+#include <atomic>
 
 class World;
 
+// Horizontal neighbours of a chunk, also used to index its border layers
+enum class NeighbourSide : uint8_t {
+    NEG_X, POS_X, NEG_Z, POS_Z
+};
+
+constexpr int32_t NEIGHBOUR_OFFSETS[][2] = { {-1, 0}, {1, 0}, {0, -1}, {0, 1} };
+
+inline NeighbourSide oppositeSide(NeighbourSide side)
+{
+    return static_cast<NeighbourSide>(static_cast<uint8_t>(side) ^ 1);
+}
+
+// Outermost block layer of each loaded neighbour facing the chunk, indexed t + CHUNK_SIZE * y
+// where t is z for the X sides and x for the Z sides. Empty when the neighbour has no data yet.
+struct ChunkNeighbours {
+    std::vector<BlockType> layers[4];
+
+    uint8_t presentMask() const
+    {
+        uint8_t mask = 0;
+        for (uint8_t i = 0; i < 4; ++i)
+            if (!layers[i].empty()) mask |= 1 << i;
+        return mask;
+    }
+};
+
+// Shared by a chunk and the jobs working on it. Set when the chunk is unloaded so
+// jobs that have not started are skipped and running ones stop at the next check.
+using CancelToken = std::shared_ptr<std::atomic<bool>>;
+
 struct ChunkMeshData {
-	std::vector<CompactBlockVertex> vertices;
-	std::vector<GLuint> indices;
+    std::vector<PackedFace> faces;
     std::pair<int, int> coord;
     glm::vec3 offset;
-    std::vector<BlockType> blocks;
+    ChunkBlocks blocks;                                 // Only set for freshly generated chunks
+    std::chrono::microseconds meshingTime{ 0 };
+    uint32_t revision = 0;
+    uint8_t neighbourMask = 0;                          // Neighbour layers the mesh was built against
+    int32_t minHeight = 0;                              // Occupied y range, empty when maxHeight < minHeight
+    int32_t maxHeight = -1;
+    int32_t solidMinHeight = 0;                         // Fully solid y range, used as an occluder
+    int32_t solidMaxHeight = -1;
+    ChunkConnectivity sectionConnectivity;
+    std::chrono::steady_clock::time_point editTime{};   // Oldest block edit the mesh includes, unset if none
+    bool loadedFromStore = false;                       // Blocks came from a region file, not from noise
+    bool readFailed = false;                            // The saved copy could not be read, blocks are from noise
+
+    ChunkMeshData() { sectionConnectivity.fill(SectionVisibility::ALL_CONNECTED); }
+
+    size_t gpuBytes() const { return faces.size() * sizeof(PackedFace); }
 };
 
 class Chunk {
 private:
-    std::vector<BlockType> chunkData;
+    ChunkBlocks chunkData;
     glm::vec3 offset;
     FastNoiseLite noise;
 
-    std::vector<CompactBlockVertex> compactVertices;
-    std::vector<GLuint> indices;
-    GLuint VAO, vertexSSBO, indexSSBO;
+    // Slice of the world's shared mesh buffers
+    MeshHandle meshHandle = MeshArena::INVALID_HANDLE;
+    size_t faceCount = 0;
+    int32_t minHeight = 0;
+    int32_t maxHeight = -1;
+    int32_t solidMinHeight = 0;
+    int32_t solidMaxHeight = -1;
+    // Sections of a chunk that has not been meshed yet are treated as open
+    ChunkConnectivity sectionConnectivity;
 
-    GLuint dummyVAO;
     World* world;
     
 
     bool readyToRender = false;
+    uint32_t uploadedRevision = 0;
+
+    // Edited since its last remesh was scheduled
+    bool dirty = false;
+    std::chrono::steady_clock::time_point dirtySince;
+
+    // Block data differs from what the region store holds for this chunk
+    bool unsaved = false;
+    // The region store could not read this chunk, so it is never written back
+    bool readOnly = false;
 
 public:
     Chunk(glm::vec3 position, std::pair<int, int> chunkCoord, World* worldRef);
     ~Chunk();
     void cleanupOpenGLResources();
-    void render(shader& shader);
-    void uploadMeshToGPU();
-    inline BlockType& getBlock(int16_t x, int16_t y, int16_t z);
+    BlockType getBlock(int16_t x, int16_t y, int16_t z) const { return chunkData.get(x, y, z); }
+    void setBlock(int16_t x, int16_t y, int16_t z, BlockType type) { chunkData.set(x, y, z, type); }
     glm::vec3 getOffset() const { return offset; }
-    void uploadMeshFromThread(const ChunkMeshData& mesh);
+    size_t getFaceCount() const { return faceCount; }
+    MeshHandle getMeshHandle() const { return meshHandle; }
+    bool isRenderable() const { return readyToRender && faceCount > 0; }
+
+    bool isDirty() const { return dirty; }
+    std::chrono::steady_clock::time_point getDirtySince() const { return dirtySince; }
+    void setDirty(bool isDirty, std::chrono::steady_clock::time_point since = {}) { dirty = isDirty; dirtySince = since; }
+
+    bool hasUnsavedChanges() const { return unsaved; }
+    void setUnsaved(bool isUnsaved) { unsaved = isUnsaved; }
+
+    bool isReadOnly() const { return readOnly; }
+    void setReadOnly(bool isReadOnly) { readOnly = isReadOnly; }
+
+    // Box around the occupied blocks, not the whole column
+    glm::vec3 getBoundsMin() const { return offset + glm::vec3(0.0f, static_cast<float>(minHeight), 0.0f); }
+    glm::vec3 getBoundsMax() const { return offset + glm::vec3(CHUNK_SIZE, static_cast<float>(maxHeight + 1), CHUNK_SIZE); }
+
+    const ChunkConnectivity& getSectionConnectivity() const { return sectionConnectivity; }
+
+    // Box that is solid throughout, can hide chunks behind it
+    bool hasOccluder() const { return solidMaxHeight >= solidMinHeight; }
+    glm::vec3 getOccluderMin() const { return offset + glm::vec3(0.0f, static_cast<float>(solidMinHeight), 0.0f); }
+    glm::vec3 getOccluderMax() const { return offset + glm::vec3(CHUNK_SIZE, static_cast<float>(solidMaxHeight + 1), CHUNK_SIZE); }
+    // Takes ownership of the mesh and, for freshly generated chunks, of the block data
+    void uploadMeshFromThread(ChunkMeshData&& mesh);
 
-    const std::vector<BlockType>& getChunkData() const { return chunkData; }
+    const ChunkBlocks& getChunkData() const { return chunkData; }
+    void setChunkData(ChunkBlocks&& blocks) { chunkData = std::move(blocks); }
+    // Lets sections edited block by block go back to empty or uniform
+    void compactBlocks() { chunkData.compact(); }
+    bool hasBlockData() const { return !chunkData.empty(); }
+    std::vector<BlockType> getBorderLayer(NeighbourSide side) const;
 
     std::pair<int, int> coord;
+    CancelToken cancelToken = std::make_shared<std::atomic<bool>>(false);
 };
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cassert>
+#include <vector>
+#include <optional>
+#include <utility>
+#include "Chunk.h"
+
+// Fixed-size toroidal grid of chunks. A chunk lives in the slot given by its coordinate
+// modulo the grid side, so a window of side x side chunks never has two chunks in the
+// same slot and a chunk entering the window reuses the slot of the one that just left.
+// Lookups are a modulo and a coordinate compare, no hashing and no lock.
+class ChunkGrid {
+public:
+    explicit ChunkGrid(int radius) : side(2 * radius + 1), slots(static_cast<size_t>(side) * side) {}
+
+    Chunk* find(const std::pair<int, int>& coord) {
+        Slot& slot = slots[index(coord)];
+        return (slot.chunk && slot.coord == coord) ? &*slot.chunk : nullptr;
+    }
+
+    bool contains(const std::pair<int, int>& coord) const {
+        const Slot& slot = slots[index(coord)];
+        return slot.chunk && slot.coord == coord;
+    }
+
+    // Slot must be free, the previous occupant has to go through World::unloadChunk first
+    // so its mesh is released and its jobs are cancelled
+    template<class... Args>
+    Chunk& emplace(const std::pair<int, int>& coord, Args&&... args) {
+        Slot& slot = slots[index(coord)];
+        assert(!slot.chunk && "ChunkGrid slot is still occupied");
+        slot.coord = coord;
+        slot.chunk.emplace(std::forward<Args>(args)...);
+        ++count;
+        return *slot.chunk;
+    }
+
+    void erase(const std::pair<int, int>& coord) {
+        Slot& slot = slots[index(coord)];
+        if (slot.chunk && slot.coord == coord) {
+            slot.chunk.reset();
+            --count;
+        }
+    }
+
+    template<class F>
+    void forEach(F&& fn) {
+        for (Slot& slot : slots) {
+            if (slot.chunk)
+                fn(*slot.chunk);
+        }
+    }
+
+    size_t size() const { return count; }
+
+private:
+    struct Slot {
+        std::pair<int, int> coord;
+        std::optional<Chunk> chunk;
+    };
+
+    size_t index(const std::pair<int, int>& coord) const {
+        return static_cast<size_t>(wrap(coord.first) + side * wrap(coord.second));
+    }
+
+    int wrap(int value) const {
+        int result = value % side;
+        return result < 0 ? result + side : result;
+    }
+
+    int side;
+    std::vector<Slot> slots;
+    size_t count = 0;
+};
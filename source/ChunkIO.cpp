@@ -0,0 +1,132 @@
+#include "ChunkIO.h"
+
+ChunkIOQueue::ChunkIOQueue(RegionStore& regionStore) : store(regionStore) {
+    thread = std::thread([this]() { run(); });
+}
+
+ChunkIOQueue::~ChunkIOQueue() {
+    closeReads();
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_one();
+    thread.join();
+
+    // Saves whose writes ran out of attempts get one last one
+    store.flushQueuedSaves();
+}
+
+void ChunkIOQueue::read(const std::pair<int, int>& chunkCoord, std::shared_ptr<std::atomic<bool>> cancelToken, ReadCompletion completion) {
+    if (readsClosed.load())
+        return;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        reads.push_back({ { chunkCoord, {} }, std::move(cancelToken), std::move(completion), 0 });
+    }
+    wake.notify_one();
+}
+
+void ChunkIOQueue::write(ChunkWrite&& write) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        writes.push_back(std::move(write));
+    }
+    wake.notify_one();
+}
+
+void ChunkIOQueue::closeReads() {
+    readsClosed.store(true);
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        reads.clear();
+    }
+    // Waits out a batch of completions that started before the flag was set
+    std::lock_guard<std::mutex> lock(completionMutex);
+}
+
+ChunkIOStats ChunkIOQueue::getStats() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return stats;
+}
+
+void ChunkIOQueue::run() {
+    std::vector<ReadRequest> readBatch;
+    std::vector<ChunkWrite> writeBatch;
+    std::vector<ChunkWrite> failedWrites;
+
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [this] { return stopping || !reads.empty() || !writes.empty(); });
+            if (stopping && reads.empty() && writes.empty())
+                return;
+            readBatch.swap(reads);
+            writeBatch.swap(writes);
+        }
+
+        if (!readBatch.empty())
+            processReads(readBatch);
+
+        if (!writeBatch.empty()) {
+            store.writeBatch(writeBatch, failedWrites);
+            std::lock_guard<std::mutex> lock(mutex);
+            stats.writes += writeBatch.size();
+            ++stats.writeBatches;
+
+            for (ChunkWrite& write : failedWrites) {
+                if (++write.attempts < MAX_WRITE_ATTEMPTS) {
+                    writes.push_back(std::move(write));
+                    ++stats.writeRetries;
+                }
+            }
+        }
+
+        readBatch.clear();
+        writeBatch.clear();
+        failedWrites.clear();
+    }
+}
+
+void ChunkIOQueue::processReads(std::vector<ReadRequest>& batch) {
+    auto readStart = std::chrono::steady_clock::now();
+
+    std::vector<ChunkRead*> live;
+    live.reserve(batch.size());
+    for (ReadRequest& request : batch) {
+        if (!request.cancelToken->load())
+            live.push_back(&request.read);
+    }
+    store.readBatch(live);
+
+    // A transient error must not look like a chunk that was never saved, so failed reads
+    // go back to the queue until they run out of attempts
+    auto retry = [](const ReadRequest& request) { return request.read.result.error && request.attempts + 1 < MAX_READ_ATTEMPTS; };
+
+    auto readTime = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - readStart);
+    size_t fromDisk = 0;
+    for (const ChunkRead* read : live)
+        fromDisk += !read->result.payload.empty();
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stats.readRequests += batch.size();
+        stats.chunksRead += fromDisk;
+        ++stats.readBatches;
+        stats.readTime += readTime;
+
+        for (const ReadRequest& request : batch) {
+            if (retry(request) && !readsClosed.load()) {
+                reads.push_back({ { request.read.coord, {} }, request.cancelToken, request.completion, request.attempts + 1 });
+                ++stats.readRetries;
+            }
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(completionMutex);
+    if (readsClosed.load())
+        return;
+    for (ReadRequest& request : batch) {
+        if (!retry(request))
+            request.completion(std::move(request.read.result));
+    }
+}
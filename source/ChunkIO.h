@@ -0,0 +1,91 @@
+#pragma once
+
+#include "RegionStore.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+struct ChunkIOStats {
+    size_t readRequests = 0;                            // Every read processed, found, missing, cancelled or retried
+    size_t chunksRead = 0;                              // Reads whose payload came from a region file
+    size_t readBatches = 0;
+    size_t readRetries = 0;                             // Failed reads queued again
+    size_t writes = 0;                                  // Encoded chunks handed to the store
+    size_t writeBatches = 0;
+    size_t writeRetries = 0;                            // Failed writes queued again
+    std::chrono::microseconds readTime{ 0 };            // Spent reading, completions excluded
+
+    double chunksReadPerSecond() const
+    {
+        return readTime.count() > 0 ? chunksRead * 1e6 / static_cast<double>(readTime.count()) : 0.0;
+    }
+};
+
+// Dedicated thread for region file I/O, so neither mesh workers nor the render thread
+// ever wait on the disk. Everything queued since the thread last woke up is one batch:
+// reads are grouped by region and read in file order, writes are grouped by region and
+// appended with one write each. Reads go first, a chunk is waiting on each of them.
+class ChunkIOQueue {
+public:
+    // A failed read is retried in the following batches, after this many attempts it
+    // completes with error set
+    static constexpr uint32_t MAX_READ_ATTEMPTS = 3;
+    // Same for writes, a save that still fails stays queued in the store until shutdown
+    static constexpr uint32_t MAX_WRITE_ATTEMPTS = 3;
+
+    // Runs on the I/O thread, should hand the result on rather than work on it
+    using ReadCompletion = std::function<void(ChunkReadResult&&)>;
+
+    explicit ChunkIOQueue(RegionStore& regionStore);
+    // Finishes every queued write, then writes whatever saves the store still holds.
+    // Queued reads are dropped.
+    ~ChunkIOQueue();
+
+    ChunkIOQueue(const ChunkIOQueue&) = delete;
+    ChunkIOQueue& operator=(const ChunkIOQueue&) = delete;
+
+    // Reads whose token is set by the time their batch runs complete with an empty
+    // result without touching the disk
+    void read(const std::pair<int, int>& chunkCoord, std::shared_ptr<std::atomic<bool>> cancelToken, ReadCompletion completion);
+
+    // Payload encoded from the store's queued save with the same ticket
+    void write(ChunkWrite&& write);
+
+    // Drops queued reads and waits for completions that are running, none run after this
+    // returns. Called before whatever the completions feed into shuts down.
+    void closeReads();
+
+    ChunkIOStats getStats();
+
+private:
+    struct ReadRequest {
+        ChunkRead read;
+        std::shared_ptr<std::atomic<bool>> cancelToken;
+        ReadCompletion completion;
+        uint32_t attempts = 0;
+    };
+
+    void run();
+    void processReads(std::vector<ReadRequest>& batch);
+
+    RegionStore& store;
+
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::vector<ReadRequest> reads;
+    std::vector<ChunkWrite> writes;
+    bool stopping = false;
+    ChunkIOStats stats;
+
+    // Held while completions run, see closeReads
+    std::mutex completionMutex;
+    std::atomic<bool> readsClosed{ false };
+
+    // Last, so everything above exists before the thread starts
+    std::thread thread;
+};
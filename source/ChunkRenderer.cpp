@@ -0,0 +1,49 @@
+#include "ChunkRenderer.h"
+
+void ChunkRenderer::submit(const DrawCommandList& drawList) {
+    if (drawList.empty())
+        return;
+
+    if (VAO == 0)
+        createResources();
+
+    // Both buffers are respecified every frame, the driver orphans the old storage
+    const auto& commands = drawList.getCommands();
+    const auto& drawData = drawList.getDrawData();
+
+    glBindBuffer(GL_ARRAY_BUFFER, drawDataBuffer);
+    glBufferData(GL_ARRAY_BUFFER, drawData.size() * sizeof(ChunkDrawData), drawData.data(), GL_STREAM_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, indirectBuffer);
+    glBufferData(GL_DRAW_INDIRECT_BUFFER, commands.size() * sizeof(DrawArraysIndirectCommand), commands.data(), GL_STREAM_DRAW);
+
+    glBindVertexArray(VAO);
+    glMultiDrawArraysIndirect(GL_TRIANGLES, nullptr, static_cast<GLsizei>(commands.size()), 0);
+    glBindVertexArray(0);
+
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+}
+
+void ChunkRenderer::cleanupOpenGLResources() {
+    if (glIsBuffer(indirectBuffer)) glDeleteBuffers(1, &indirectBuffer);
+    if (glIsBuffer(drawDataBuffer)) glDeleteBuffers(1, &drawDataBuffer);
+    if (glIsVertexArray(VAO)) glDeleteVertexArrays(1, &VAO);
+    VAO = indirectBuffer = drawDataBuffer = 0;
+}
+
+void ChunkRenderer::createResources() {
+    glGenVertexArrays(1, &VAO);
+    glGenBuffers(1, &indirectBuffer);
+    glGenBuffers(1, &drawDataBuffer);
+
+    // One ChunkDrawData per instance. Every command draws one instance starting at
+    // baseInstance = its draw index, so attribute 0 holds that draw's data.
+    glBindVertexArray(VAO);
+    glBindBuffer(GL_ARRAY_BUFFER, drawDataBuffer);
+    glEnableVertexAttribArray(0);
+    glVertexAttribIPointer(0, 3, GL_INT, sizeof(ChunkDrawData), nullptr);
+    glVertexAttribDivisor(0, 1);
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
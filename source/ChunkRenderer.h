@@ -0,0 +1,19 @@
+#pragma once
+
+#include <glad/glad.h>
+#include "DrawCommandList.h"
+
+// Draws a whole DrawCommandList with one glMultiDrawArraysIndirect. The mesh arena's
+// face buffer has to be bound to SSBO binding 0 beforehand.
+class ChunkRenderer {
+public:
+    void submit(const DrawCommandList& drawList);
+    void cleanupOpenGLResources();
+
+private:
+    void createResources();
+
+    GLuint VAO = 0;
+    GLuint indirectBuffer = 0;
+    GLuint drawDataBuffer = 0;
+};
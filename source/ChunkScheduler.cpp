@@ -0,0 +1,68 @@
+#include "ChunkScheduler.h"
+#include "ChunkStorage.h"
+#include <algorithm>
+
+void ChunkScheduler::push(const std::pair<int, int>& coord, Task&& work, bool urgent)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    jobs.push_back({ coord, priority(coord), urgent, std::move(work) });
+    std::push_heap(jobs.begin(), jobs.end(), later);
+}
+
+bool ChunkScheduler::pop(Task& work)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    if (jobs.empty())
+        return false;
+
+    std::pop_heap(jobs.begin(), jobs.end(), later);
+    work = std::move(jobs.back().work);
+    jobs.pop_back();
+    return true;
+}
+
+size_t ChunkScheduler::cancel(const std::pair<int, int>& coord)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    auto removed = std::remove_if(jobs.begin(), jobs.end(),
+        [&coord](const ScheduledJob& job) { return job.coord == coord; });
+    size_t count = static_cast<size_t>(jobs.end() - removed);
+    if (count > 0) {
+        jobs.erase(removed, jobs.end());
+        std::make_heap(jobs.begin(), jobs.end(), later);
+    }
+    return count;
+}
+
+void ChunkScheduler::setFocus(glm::vec3 playerPosition, glm::vec3 lookDirection)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    focusPosition = glm::vec2(playerPosition.x, playerPosition.z);
+
+    // Looking straight up or down leaves no horizontal preference
+    glm::vec2 direction(lookDirection.x, lookDirection.z);
+    float length = glm::length(direction);
+    focusDirection = (length > 1e-4f) ? direction / length : glm::vec2(0.0f);
+
+    for (ScheduledJob& job : jobs)
+        job.priority = priority(job.coord);
+    std::make_heap(jobs.begin(), jobs.end(), later);
+}
+
+float ChunkScheduler::priority(const std::pair<int, int>& coord) const
+{
+    glm::vec2 chunkCenter = (glm::vec2(coord.first, coord.second) + 0.5f) * static_cast<float>(CHUNK_SIZE);
+    glm::vec2 toChunk = chunkCenter - focusPosition;
+    float distance = glm::length(toChunk);
+    if (distance < 1e-4f)
+        return 0.0f;
+
+    float facing = glm::dot(toChunk / distance, focusDirection);
+    return distance * (1.0f + VIEW_WEIGHT * (1.0f - facing) * 0.5f);
+}
+
+size_t ChunkScheduler::size()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return jobs.size();
+}
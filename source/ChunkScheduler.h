@@ -0,0 +1,55 @@
+#pragma once
+
+#include <glm.hpp>
+#include <mutex>
+#include <vector>
+#include <utility>
+#include "ThreadPool.h"
+
+// Orders chunk jobs by how soon the player is likely to see them: distance from the
+// player, stretched for chunks away from the look direction. Jobs stay here until a
+// worker is free, so re-prioritising when the camera moves also reorders work that
+// has been queued but not started yet.
+class ChunkScheduler {
+public:
+    // Chunks directly behind the camera are treated as this much further away
+    static constexpr float VIEW_WEIGHT = 1.0f;
+
+    // Urgent jobs, such as remeshes after a block edit, run before any other job
+    void push(const std::pair<int, int>& coord, Task&& work, bool urgent = false);
+
+    // Takes the highest priority job, false if there is none
+    bool pop(Task& work);
+
+    // Drops every queued job for the chunk, returns how many were dropped
+    size_t cancel(const std::pair<int, int>& coord);
+
+    // Moves the focus and re-sorts every queued job
+    void setFocus(glm::vec3 playerPosition, glm::vec3 lookDirection);
+
+    // Lower is sooner
+    float priority(const std::pair<int, int>& coord) const;
+
+    size_t size();
+
+private:
+    struct ScheduledJob {
+        std::pair<int, int> coord;
+        float priority;
+        bool urgent;
+        Task work;
+    };
+
+    // Min-heap on urgency, then priority
+    static bool later(const ScheduledJob& a, const ScheduledJob& b)
+    {
+        if (a.urgent != b.urgent)
+            return b.urgent;
+        return a.priority > b.priority;
+    }
+
+    std::mutex mutex;
+    std::vector<ScheduledJob> jobs;
+    glm::vec2 focusPosition{ 0.0f };
+    glm::vec2 focusDirection{ 1.0f, 0.0f };
+};
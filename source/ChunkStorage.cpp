@@ -0,0 +1,274 @@
+#include "ChunkStorage.h"
+#include <algorithm>
+
+static constexpr uint8_t MAX_BITS_SHIFT = 4;    // 16 bits per entry
+
+ChunkStorage::ChunkStorage(size_t size, BlockType fill) : palette{ fill }, entryCount(size)
+{
+    setWidth(0);
+    words.assign((entryCount + entriesPerWordMask) >> entriesPerWordShift, 0);
+}
+
+ChunkStorage::ChunkStorage(const std::vector<BlockType>& blocks) : entryCount(blocks.size())
+{
+    // Collect the palette first so the data is packed once at its final width
+    BlockType lastType = BlockType::AIR;
+    uint32_t lastIndex = UINT32_MAX;
+    std::vector<uint32_t> indices(blocks.size());
+    for (size_t i = 0; i < blocks.size(); ++i) {
+        if (blocks[i] != lastType || lastIndex == UINT32_MAX) {
+            lastType = blocks[i];
+            lastIndex = 0;
+            while (lastIndex < palette.size() && palette[lastIndex] != lastType)
+                ++lastIndex;
+            if (lastIndex == palette.size())
+                palette.push_back(lastType);
+        }
+        indices[i] = lastIndex;
+    }
+    if (palette.empty())
+        palette.push_back(BlockType::AIR);
+
+    setWidth(bitsShiftFor(palette.size()));
+    words.assign((entryCount + entriesPerWordMask) >> entriesPerWordShift, 0);
+    for (size_t i = 0; i < indices.size(); ++i) {
+        const uint32_t shift = static_cast<uint32_t>(i & entriesPerWordMask) << bitsShift;
+        words[i >> entriesPerWordShift] |= static_cast<uint64_t>(indices[i]) << shift;
+    }
+}
+
+void ChunkStorage::set(size_t index, BlockType type)
+{
+    const uint64_t value = paletteIndex(type);
+    uint64_t& word = words[index >> entriesPerWordShift];
+    const uint32_t shift = static_cast<uint32_t>(index & entriesPerWordMask) << bitsShift;
+    word = (word & ~(entryMask << shift)) | (value << shift);
+}
+
+void ChunkStorage::unpack(std::vector<BlockType>& out) const
+{
+    out.resize(entryCount);
+    const uint32_t entriesPerWord = 1u << entriesPerWordShift;
+    const uint32_t bits = 1u << bitsShift;
+
+    size_t i = 0;
+    for (uint64_t word : words) {
+        for (uint32_t e = 0; e < entriesPerWord && i < entryCount; ++e, ++i) {
+            out[i] = palette[word & entryMask];
+            word >>= bits;
+        }
+    }
+}
+
+void ChunkStorage::compact()
+{
+    if (entryCount == 0)
+        return;
+
+    // Repacking from the dense form rebuilds the palette from the types actually present
+    std::vector<BlockType> blocks;
+    unpack(blocks);
+    *this = ChunkStorage(blocks);
+}
+
+size_t ChunkStorage::memoryUsage() const
+{
+    return sizeof(ChunkStorage) + palette.capacity() * sizeof(BlockType) + words.capacity() * sizeof(uint64_t);
+}
+
+uint32_t ChunkStorage::paletteIndex(BlockType type)
+{
+    for (uint32_t i = 0; i < palette.size(); ++i)
+        if (palette[i] == type)
+            return i;
+
+    palette.push_back(type);
+    const uint8_t requiredShift = bitsShiftFor(palette.size());
+    if (requiredShift != bitsShift)
+        repack(requiredShift);
+    return static_cast<uint32_t>(palette.size() - 1);
+}
+
+void ChunkStorage::repack(uint8_t newBitsShift)
+{
+    std::vector<uint64_t> oldWords = std::move(words);
+    const uint8_t oldBitsShift = bitsShift;
+    const uint8_t oldEntriesShift = entriesPerWordShift;
+    const uint64_t oldEntriesMask = entriesPerWordMask;
+    const uint64_t oldEntryMask = entryMask;
+
+    setWidth(newBitsShift);
+    words.assign((entryCount + entriesPerWordMask) >> entriesPerWordShift, 0);
+    for (size_t i = 0; i < entryCount; ++i) {
+        const uint32_t oldShift = static_cast<uint32_t>(i & oldEntriesMask) << oldBitsShift;
+        const uint64_t value = (oldWords[i >> oldEntriesShift] >> oldShift) & oldEntryMask;
+        const uint32_t shift = static_cast<uint32_t>(i & entriesPerWordMask) << bitsShift;
+        words[i >> entriesPerWordShift] |= value << shift;
+    }
+}
+
+void ChunkStorage::setWidth(uint8_t newBitsShift)
+{
+    bitsShift = newBitsShift;
+    entriesPerWordShift = 6 - bitsShift;
+    entriesPerWordMask = (1ull << entriesPerWordShift) - 1;
+    entryMask = (1ull << (1u << bitsShift)) - 1;
+}
+
+uint8_t ChunkStorage::bitsShiftFor(size_t paletteSize)
+{
+    uint8_t shift = 0;
+    while (shift < MAX_BITS_SHIFT && (1ull << (1u << shift)) < paletteSize)
+        ++shift;
+    return shift;
+}
+
+ChunkSection::ChunkSection(const BlockType* blocks)
+{
+    const BlockType first = blocks[0];
+    for (int32_t i = 1; i < SECTION_VOLUME; ++i) {
+        if (blocks[i] != first) {
+            state = SectionState::MIXED;
+            storage = ChunkStorage(std::vector<BlockType>(blocks, blocks + SECTION_VOLUME));
+            return;
+        }
+    }
+    makeUniform(first);
+}
+
+void ChunkSection::set(int32_t localIndex, BlockType type)
+{
+    if (state != SectionState::MIXED) {
+        if (type == uniformType)
+            return;
+        storage = ChunkStorage(SECTION_VOLUME, uniformType);
+        state = SectionState::MIXED;
+    }
+    storage.set(localIndex, type);
+}
+
+void ChunkSection::unpack(BlockType* out) const
+{
+    if (state != SectionState::MIXED) {
+        std::fill(out, out + SECTION_VOLUME, uniformType);
+        return;
+    }
+
+    std::vector<BlockType> blocks;
+    storage.unpack(blocks);
+    std::copy(blocks.begin(), blocks.end(), out);
+}
+
+void ChunkSection::compact()
+{
+    if (state != SectionState::MIXED)
+        return;
+
+    storage.compact();
+    if (storage.getPalette().size() == 1)
+        makeUniform(storage.getPalette()[0]);
+}
+
+void ChunkSection::makeUniform(BlockType type)
+{
+    state = (type == BlockType::AIR) ? SectionState::EMPTY : SectionState::UNIFORM;
+    uniformType = type;
+    storage = ChunkStorage();
+}
+
+ChunkBlocks::ChunkBlocks(const std::vector<BlockType>& blocks)
+{
+    sections.reserve(SECTION_COUNT);
+    for (int32_t s = 0; s < SECTION_COUNT; ++s)
+        sections.emplace_back(blocks.data() + s * SECTION_VOLUME);
+}
+
+void ChunkBlocks::unpack(std::vector<BlockType>& out) const
+{
+    out.resize(CHUNK_VOLUME);
+    for (int32_t s = 0; s < SECTION_COUNT; ++s)
+        sections[s].unpack(out.data() + s * SECTION_VOLUME);
+}
+
+void ChunkBlocks::compact()
+{
+    for (ChunkSection& section : sections)
+        section.compact();
+}
+
+SectionStates ChunkBlocks::getSectionStates() const
+{
+    SectionStates states;
+    for (int32_t s = 0; s < SECTION_COUNT; ++s)
+        states[s] = sections.empty() ? SectionState::EMPTY : sections[s].getState();
+    return states;
+}
+
+size_t ChunkBlocks::memoryUsage() const
+{
+    size_t bytes = sizeof(ChunkBlocks) + sections.capacity() * sizeof(ChunkSection);
+    for (const ChunkSection& section : sections)
+        bytes += section.memoryUsage();
+    return bytes;
+}
+
+static bool isLayerSolid(const std::vector<BlockType>& blocks, int32_t y)
+{
+    const BlockType* layer = blocks.data() + blockIndex(0, y, 0);
+    return std::none_of(layer, layer + CHUNK_SIZE * CHUNK_SIZE, [](BlockType type) { return type == BlockType::AIR; });
+}
+
+static bool isLayerOccupied(const std::vector<BlockType>& blocks, int32_t y)
+{
+    const BlockType* layer = blocks.data() + blockIndex(0, y, 0);
+    return std::any_of(layer, layer + CHUNK_SIZE * CHUNK_SIZE, [](BlockType type) { return type != BlockType::AIR; });
+}
+
+std::pair<int32_t, int32_t> occupiedHeightRange(const std::vector<BlockType>& blocks, const SectionStates& sections)
+{
+    int32_t minY = -1;
+    for (int32_t s = 0; s < SECTION_COUNT && minY < 0; ++s) {
+        if (sections[s] == SectionState::EMPTY)
+            continue;
+        for (int32_t y = s * SECTION_HEIGHT; y < (s + 1) * SECTION_HEIGHT && minY < 0; ++y) {
+            if (isLayerOccupied(blocks, y))
+                minY = y;
+        }
+    }
+    if (minY < 0)
+        return { 0, -1 };
+
+    int32_t maxY = minY;
+    for (int32_t s = SECTION_COUNT - 1; s >= 0; --s) {
+        if (sections[s] == SectionState::EMPTY)
+            continue;
+        for (int32_t y = (s + 1) * SECTION_HEIGHT - 1; y >= s * SECTION_HEIGHT; --y) {
+            if (isLayerOccupied(blocks, y))
+                return { minY, y };
+        }
+    }
+    return { minY, maxY };
+}
+
+std::pair<int32_t, int32_t> solidHeightRange(const std::vector<BlockType>& blocks, const SectionStates& sections)
+{
+    std::pair<int32_t, int32_t> best = { 0, -1 };
+    int32_t runStart = -1;
+    for (int32_t y = 0; y <= CHUNK_HEIGHT; ++y) {
+        // Uniform sections are solid throughout, empty ones have no solid layer at all
+        bool solid = false;
+        if (y < CHUNK_HEIGHT) {
+            SectionState state = sections[y / SECTION_HEIGHT];
+            solid = state == SectionState::UNIFORM || (state == SectionState::MIXED && isLayerSolid(blocks, y));
+        }
+
+        if (solid && runStart < 0)
+            runStart = y;
+        else if (!solid && runStart >= 0) {
+            if (y - runStart > best.second - best.first + 1)
+                best = { runStart, y - 1 };
+            runStart = -1;
+        }
+    }
+    return best;
+}
@@ -0,0 +1,144 @@
+#pragma once
+
+#include "Block.h"
+#include <vector>
+#include <array>
+#include <cstdint>
+#include <utility>
+
+constexpr int32_t CHUNK_SIZE = 16;                      // Number of blocks along x, z
+constexpr int32_t CHUNK_HEIGHT = 128;                   // Number of blocks along y
+constexpr int32_t SECTION_HEIGHT = 16;                  // Number of blocks along y in one section
+constexpr int32_t SECTION_COUNT = CHUNK_HEIGHT / SECTION_HEIGHT;
+constexpr int32_t SECTION_VOLUME = CHUNK_SIZE * SECTION_HEIGHT * CHUNK_SIZE;
+constexpr int32_t CHUNK_VOLUME = CHUNK_SIZE * CHUNK_HEIGHT * CHUNK_SIZE;
+
+static_assert(CHUNK_HEIGHT % SECTION_HEIGHT == 0, "Chunks are made of whole sections");
+
+// Y-major so every section is one contiguous run of SECTION_VOLUME blocks
+inline int32_t blockIndex(int32_t x, int32_t y, int32_t z)
+{
+    return x + CHUNK_SIZE * (z + CHUNK_SIZE * y);
+}
+
+// Palette-compressed block storage. Every entry is an index into a palette of the
+// distinct block types it holds, bit-packed into 64-bit words. Entry width is the
+// smallest power of two (1, 2, 4, 8 or 16 bits) that can address the palette, so
+// entries never straddle a word and get/set stay shifts and masks.
+class ChunkStorage {
+public:
+    ChunkStorage() = default;
+    explicit ChunkStorage(size_t size, BlockType fill = BlockType::AIR);
+    explicit ChunkStorage(const std::vector<BlockType>& blocks);
+
+    BlockType get(size_t index) const
+    {
+        const uint64_t word = words[index >> entriesPerWordShift];
+        const uint32_t shift = static_cast<uint32_t>(index & entriesPerWordMask) << bitsShift;
+        return palette[(word >> shift) & entryMask];
+    }
+
+    void set(size_t index, BlockType type);
+
+    // Decodes every entry into a dense array, one word at a time
+    void unpack(std::vector<BlockType>& out) const;
+
+    // Drops palette entries that are no longer referenced and shrinks the entry width
+    void compact();
+
+    size_t size() const { return entryCount; }
+    bool empty() const { return entryCount == 0; }
+    uint8_t getBitsPerEntry() const { return static_cast<uint8_t>(1u << bitsShift); }
+    const std::vector<BlockType>& getPalette() const { return palette; }
+    size_t memoryUsage() const;
+
+private:
+    uint32_t paletteIndex(BlockType type);
+    void repack(uint8_t newBitsShift);
+    void setWidth(uint8_t newBitsShift);
+    static uint8_t bitsShiftFor(size_t paletteSize);
+
+    std::vector<BlockType> palette;
+    std::vector<uint64_t> words;
+    size_t entryCount = 0;
+
+    // Entry width is 1 << bitsShift bits, 64 >> bitsShift entries per word
+    uint8_t bitsShift = 0;
+    uint8_t entriesPerWordShift = 6;
+    uint64_t entriesPerWordMask = 63;
+    uint64_t entryMask = 1;
+};
+
+enum class SectionState : uint8_t {
+    EMPTY,      // Only air, nothing stored
+    UNIFORM,    // A single non-air type, nothing stored
+    MIXED       // Palette-compressed storage
+};
+
+using SectionStates = std::array<SectionState, SECTION_COUNT>;
+
+// Lowest and highest y holding a non-air block in dense y-major chunk data, {0, -1}
+// when there is none. Empty sections are skipped without looking at their blocks.
+std::pair<int32_t, int32_t> occupiedHeightRange(const std::vector<BlockType>& blocks, const SectionStates& sections);
+
+// Longest run of layers in which every block is non-air, {0, -1} when there is none.
+// The box it spans is solid all the way through and can hide what is behind it.
+std::pair<int32_t, int32_t> solidHeightRange(const std::vector<BlockType>& blocks, const SectionStates& sections);
+
+// A 16-high slice of a chunk. Empty and uniform sections store only their type.
+class ChunkSection {
+public:
+    ChunkSection() = default;
+    explicit ChunkSection(const BlockType* blocks);
+
+    BlockType get(int32_t localIndex) const
+    {
+        return state == SectionState::MIXED ? storage.get(localIndex) : uniformType;
+    }
+
+    void set(int32_t localIndex, BlockType type);
+    void unpack(BlockType* out) const;
+
+    // Turns mixed sections that have become uniform back into a single type
+    void compact();
+
+    SectionState getState() const { return state; }
+    BlockType getUniformType() const { return uniformType; }
+    size_t memoryUsage() const { return state == SectionState::MIXED ? storage.memoryUsage() : 0; }
+
+private:
+    void makeUniform(BlockType type);
+
+    SectionState state = SectionState::EMPTY;
+    BlockType uniformType = BlockType::AIR;
+    ChunkStorage storage;
+};
+
+// Block data of a whole chunk as SECTION_COUNT vertical sections.
+// Default-constructed instances hold no data, meaning the chunk is not generated yet.
+class ChunkBlocks {
+public:
+    ChunkBlocks() = default;
+    explicit ChunkBlocks(const std::vector<BlockType>& blocks);
+
+    BlockType get(int32_t x, int32_t y, int32_t z) const
+    {
+        return sections[y / SECTION_HEIGHT].get(blockIndex(x, y % SECTION_HEIGHT, z));
+    }
+
+    void set(int32_t x, int32_t y, int32_t z, BlockType type)
+    {
+        sections[y / SECTION_HEIGHT].set(blockIndex(x, y % SECTION_HEIGHT, z), type);
+    }
+
+    void unpack(std::vector<BlockType>& out) const;
+    void compact();
+
+    bool empty() const { return sections.empty(); }
+    const ChunkSection& getSection(int32_t index) const { return sections[index]; }
+    SectionStates getSectionStates() const;
+    size_t memoryUsage() const;
+
+private:
+    std::vector<ChunkSection> sections;
+};
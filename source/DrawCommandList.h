@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <glm.hpp>
+#include "MeshArena.h"
+
+// Same layout as GL's DrawArraysIndirectCommand
+struct DrawArraysIndirectCommand {
+    uint32_t count;
+    uint32_t instanceCount;
+    uint32_t first;
+    uint32_t baseInstance;
+};
+
+// Per-draw data, fetched in the vertex shader through an instanced attribute
+// that baseInstance points at
+struct ChunkDrawData {
+    int32_t offsetX;
+    int32_t offsetY;
+    int32_t offsetZ;
+};
+
+// Every face is drawn as two triangles expanded in the vertex shader
+constexpr uint32_t VERTICES_PER_FACE = 6;
+
+// CPU side of a multi-draw: one indirect command and one ChunkDrawData per chunk.
+// Building it touches no GL state, ChunkRenderer submits it.
+class DrawCommandList {
+public:
+    void clear() {
+        commands.clear();
+        drawData.clear();
+    }
+
+    void reserve(size_t count) {
+        commands.reserve(count);
+        drawData.reserve(count);
+    }
+
+    void add(const MeshSlice& slice, glm::ivec3 chunkOrigin) {
+        if (slice.faceCount == 0)
+            return;
+
+        // gl_VertexID starts at `first`, so gl_VertexID / 6 indexes the shared face buffer
+        uint32_t drawIndex = static_cast<uint32_t>(commands.size());
+        commands.push_back({ slice.faceCount * VERTICES_PER_FACE, 1, slice.faceOffset * VERTICES_PER_FACE, drawIndex });
+        drawData.push_back({ chunkOrigin.x, chunkOrigin.y, chunkOrigin.z });
+    }
+
+    const std::vector<DrawArraysIndirectCommand>& getCommands() const { return commands; }
+    const std::vector<ChunkDrawData>& getDrawData() const { return drawData; }
+    size_t size() const { return commands.size(); }
+    bool empty() const { return commands.empty(); }
+
+private:
+    std::vector<DrawArraysIndirectCommand> commands;
+    std::vector<ChunkDrawData> drawData;
+};
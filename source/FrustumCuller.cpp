@@ -0,0 +1,133 @@
+#include "FrustumCuller.h"
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#define FRUSTUM_AVX
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define FRUSTUM_SSE
+#endif
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+static inline uint32_t countTrailingZeros(uint32_t value)
+{
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward(&index, value);
+    return index;
+#else
+    return static_cast<uint32_t>(__builtin_ctz(value));
+#endif
+}
+
+void FrustumCuller::setFrustum(const glm::mat4& projectionView) {
+    // Gribb/Hartmann: each plane is the last row of the matrix plus or minus another row.
+    // GLM is column-major, so row i is m[0][i], m[1][i], m[2][i], m[3][i].
+    auto row = [&projectionView](int i) {
+        return glm::vec4(projectionView[0][i], projectionView[1][i], projectionView[2][i], projectionView[3][i]);
+    };
+    glm::vec4 x = row(0), y = row(1), z = row(2), w = row(3);
+    planes = { w + x, w - x, w + y, w - y, w + z, w - z };
+}
+
+void FrustumCuller::clear() {
+    count = 0;
+    for (std::vector<float>* axis : { &minX, &minY, &minZ, &maxX, &maxY, &maxZ })
+        axis->clear();
+}
+
+void FrustumCuller::reserve(size_t boxes) {
+    size_t padded = (boxes + BATCH - 1) / BATCH * BATCH;
+    for (std::vector<float>* axis : { &minX, &minY, &minZ, &maxX, &maxY, &maxZ })
+        axis->reserve(padded);
+}
+
+void FrustumCuller::addBox(const glm::vec3& min, const glm::vec3& max) {
+    // Grow all arrays by a whole batch at a time, the padding is ignored by cull()
+    if (count % BATCH == 0) {
+        for (std::vector<float>* axis : { &minX, &minY, &minZ, &maxX, &maxY, &maxZ })
+            axis->resize(count + BATCH, 0.0f);
+    }
+    minX[count] = min.x; minY[count] = min.y; minZ[count] = min.z;
+    maxX[count] = max.x; maxY[count] = max.y; maxZ[count] = max.z;
+    ++count;
+}
+
+bool FrustumCuller::isVisible(const glm::vec3& min, const glm::vec3& max) const {
+    // A box is outside when its corner furthest along a plane's normal is behind it
+    for (const glm::vec4& plane : planes) {
+        glm::vec3 corner(plane.x >= 0.0f ? max.x : min.x,
+                         plane.y >= 0.0f ? max.y : min.y,
+                         plane.z >= 0.0f ? max.z : min.z);
+        if (plane.x * corner.x + plane.y * corner.y + plane.z * corner.z + plane.w < 0.0f)
+            return false;
+    }
+    return true;
+}
+
+void FrustumCuller::cull(std::vector<uint32_t>& visible) const {
+    // Which corner counts only depends on the signs of the plane normal, so it is
+    // picked once per plane as a choice between the min and max arrays
+    const float* cornerX[6];
+    const float* cornerY[6];
+    const float* cornerZ[6];
+    for (int p = 0; p < 6; ++p) {
+        cornerX[p] = planes[p].x >= 0.0f ? maxX.data() : minX.data();
+        cornerY[p] = planes[p].y >= 0.0f ? maxY.data() : minY.data();
+        cornerZ[p] = planes[p].z >= 0.0f ? maxZ.data() : minZ.data();
+    }
+
+    for (size_t base = 0; base < count; base += BATCH) {
+        uint32_t insideMask;
+
+#if defined(FRUSTUM_AVX)
+        __m256 inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+        for (int p = 0; p < 6; ++p) {
+            __m256 distance = _mm256_add_ps(
+                _mm256_add_ps(_mm256_mul_ps(_mm256_loadu_ps(cornerX[p] + base), _mm256_set1_ps(planes[p].x)),
+                              _mm256_mul_ps(_mm256_loadu_ps(cornerY[p] + base), _mm256_set1_ps(planes[p].y))),
+                _mm256_add_ps(_mm256_mul_ps(_mm256_loadu_ps(cornerZ[p] + base), _mm256_set1_ps(planes[p].z)),
+                              _mm256_set1_ps(planes[p].w)));
+            inside = _mm256_and_ps(inside, _mm256_cmp_ps(distance, _mm256_setzero_ps(), _CMP_GE_OQ));
+        }
+        insideMask = static_cast<uint32_t>(_mm256_movemask_ps(inside));
+#elif defined(FRUSTUM_SSE)
+        insideMask = 0;
+        for (size_t half = 0; half < BATCH; half += 4) {
+            __m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+            for (int p = 0; p < 6; ++p) {
+                size_t i = base + half;
+                __m128 distance = _mm_add_ps(
+                    _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(cornerX[p] + i), _mm_set1_ps(planes[p].x)),
+                               _mm_mul_ps(_mm_loadu_ps(cornerY[p] + i), _mm_set1_ps(planes[p].y))),
+                    _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(cornerZ[p] + i), _mm_set1_ps(planes[p].z)),
+                               _mm_set1_ps(planes[p].w)));
+                inside = _mm_and_ps(inside, _mm_cmpge_ps(distance, _mm_setzero_ps()));
+            }
+            insideMask |= static_cast<uint32_t>(_mm_movemask_ps(inside)) << half;
+        }
+#else
+        insideMask = 0;
+        for (size_t lane = 0; lane < BATCH; ++lane) {
+            bool inside = true;
+            for (int p = 0; p < 6 && inside; ++p) {
+                size_t i = base + lane;
+                inside = cornerX[p][i] * planes[p].x + cornerY[p][i] * planes[p].y
+                    + cornerZ[p][i] * planes[p].z + planes[p].w >= 0.0f;
+            }
+            insideMask |= static_cast<uint32_t>(inside) << lane;
+        }
+#endif
+
+        // Drop the padding lanes of the last batch
+        if (count - base < BATCH)
+            insideMask &= (1u << (count - base)) - 1;
+
+        while (insideMask) {
+            visible.push_back(static_cast<uint32_t>(base + countTrailingZeros(insideMask)));
+            insideMask &= insideMask - 1;
+        }
+    }
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <glm.hpp>
+#include <array>
+#include <cstdint>
+#include <vector>
+
+// Tests axis-aligned boxes against the view frustum. Boxes are stored as separate
+// min/max arrays per axis so a batch of them is tested against one plane at a time
+// with SIMD (8 boxes with AVX, 4 with SSE, scalar otherwise). No GL involved.
+class FrustumCuller {
+public:
+    // Extracts the six planes from projection * view
+    void setFrustum(const glm::mat4& projectionView);
+
+    void clear();
+    void reserve(size_t count);
+    void addBox(const glm::vec3& min, const glm::vec3& max);
+    size_t size() const { return count; }
+
+    // Appends the index, in addBox order, of every box that is at least partly inside
+    void cull(std::vector<uint32_t>& visible) const;
+
+    // Same test for one box, without batching
+    bool isVisible(const glm::vec3& min, const glm::vec3& max) const;
+
+private:
+    static constexpr size_t BATCH = 8;
+
+    // Plane as n.x * x + n.y * y + n.z * z + w >= 0 for points inside
+    std::array<glm::vec4, 6> planes{};
+
+    // Kept padded to a multiple of BATCH so every batch can be loaded whole
+    std::vector<float> minX, minY, minZ, maxX, maxY, maxZ;
+    size_t count = 0;
+};
@@ -0,0 +1,102 @@
+#include "MappedFile.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+
+bool MappedFile::map(const std::string& path, size_t size)
+{
+    unmap();
+
+    // Shared so the region file can keep its own handle for payload reads and writes
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE,
+        nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        return false;
+
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READWRITE, 0, static_cast<DWORD>(size), nullptr);
+    if (!mapping) {
+        CloseHandle(file);
+        return false;
+    }
+
+    void* mapped = MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, size);
+    if (!mapped) {
+        CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+    }
+
+    fileHandle = file;
+    mappingHandle = mapping;
+    view = static_cast<uint8_t*>(mapped);
+    length = size;
+    return true;
+}
+
+void MappedFile::unmap()
+{
+    if (view)
+        UnmapViewOfFile(view);
+    if (mappingHandle)
+        CloseHandle(mappingHandle);
+    if (fileHandle)
+        CloseHandle(fileHandle);
+    view = nullptr;
+    mappingHandle = nullptr;
+    fileHandle = nullptr;
+    length = 0;
+}
+
+void MappedFile::flush()
+{
+    if (view)
+        FlushViewOfFile(view, length);
+}
+
+#else
+
+bool MappedFile::map(const std::string& path, size_t size)
+{
+    unmap();
+
+    int fd = ::open(path.c_str(), O_RDWR);
+    if (fd < 0)
+        return false;
+
+    void* mapped = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (mapped == MAP_FAILED) {
+        ::close(fd);
+        return false;
+    }
+
+    fileDescriptor = fd;
+    view = static_cast<uint8_t*>(mapped);
+    length = size;
+    return true;
+}
+
+void MappedFile::unmap()
+{
+    if (view)
+        munmap(view, length);
+    if (fileDescriptor >= 0)
+        ::close(fileDescriptor);
+    view = nullptr;
+    fileDescriptor = -1;
+    length = 0;
+}
+
+void MappedFile::flush()
+{
+    if (view)
+        msync(view, length, MS_ASYNC);
+}
+
+#endif
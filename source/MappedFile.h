@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Shared read-write mapping of the first `size` bytes of an existing file. Writes through
+// data() end up in the file, reads see whatever was written to it through other handles.
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile() { unmap(); }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // The file must already be at least `size` bytes long
+    bool map(const std::string& path, size_t size);
+    void unmap();
+
+    // Writes dirty pages back to the file
+    void flush();
+
+    uint8_t* data() const { return view; }
+    size_t size() const { return length; }
+    bool isMapped() const { return view != nullptr; }
+
+private:
+#ifdef _WIN32
+    void* fileHandle = nullptr;
+    void* mappingHandle = nullptr;
+#else
+    int fileDescriptor = -1;
+#endif
+    uint8_t* view = nullptr;
+    size_t length = 0;
+};
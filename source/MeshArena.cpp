@@ -0,0 +1,146 @@
+#include "MeshArena.h"
+#include <algorithm>
+
+MeshArena::MeshArena(uint32_t faceCapacity) : allocator(faceCapacity) {}
+
+MeshHandle MeshArena::upload(MeshHandle handle, const std::vector<PackedFace>& faces) {
+    if (handle == INVALID_HANDLE) {
+        if (!freeHandles.empty()) {
+            handle = freeHandles.back();
+            freeHandles.pop_back();
+        }
+        else {
+            handle = static_cast<MeshHandle>(slices.size());
+            slices.emplace_back();
+        }
+    }
+    else {
+        // The old range is freed first so a remesh of the same size lands in place
+        MeshSlice& old = slices[handle];
+        if (old.faceCount > 0) allocator.free(old.faceOffset);
+        old = MeshSlice();
+    }
+
+    // Allocating can move every other slice, so this one is only written afterwards
+    uint32_t faceCount = static_cast<uint32_t>(faces.size());
+    uint32_t faceOffset = allocate(faceCount);
+    write(faceOffset, faces);
+
+    slices[handle] = { faceOffset, faceCount };
+    return handle;
+}
+
+void MeshArena::release(MeshHandle handle) {
+    if (handle == INVALID_HANDLE)
+        return;
+
+    MeshSlice& slice = slices[handle];
+    if (slice.faceCount > 0) allocator.free(slice.faceOffset);
+    slice = MeshSlice();
+    freeHandles.push_back(handle);
+}
+
+void MeshArena::bind() const {
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, buffer);
+}
+
+void MeshArena::defragment() {
+    relocate(allocator.getCapacity());
+    ++defragmentations;
+}
+
+MeshArenaStats MeshArena::getStats() const {
+    MeshArenaStats stats;
+    stats.faces = allocator.getStats();
+    stats.meshCount = static_cast<uint32_t>(slices.size() - freeHandles.size());
+    stats.defragmentations = defragmentations;
+    stats.growths = growths;
+    return stats;
+}
+
+void MeshArena::cleanupOpenGLResources() {
+    if (glIsBuffer(buffer)) {
+        glDeleteBuffers(1, &buffer);
+        buffer = 0;
+    }
+}
+
+uint32_t MeshArena::allocate(uint32_t count) {
+    if (count == 0)
+        return 0;
+
+    uint32_t offset = allocator.allocate(count);
+    if (offset != OffsetAllocator::INVALID_OFFSET)
+        return offset;
+
+    // Enough space in total means it is only fragmented, otherwise the buffer doubles.
+    // Either way everything is packed, which leaves one free block at the end.
+    AllocatorStats stats = allocator.getStats();
+    if (stats.capacity - stats.used >= count) {
+        relocate(stats.capacity);
+        ++defragmentations;
+    }
+    else {
+        relocate(std::max(stats.capacity * 2, stats.used + count));
+        ++growths;
+    }
+    return allocator.allocate(count);
+}
+
+void MeshArena::write(uint32_t offset, const std::vector<PackedFace>& faces) {
+    if (faces.empty())
+        return;
+
+    if (buffer == 0)
+        buffer = createBuffer(allocator.getCapacity() * sizeof(PackedFace));
+
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, buffer);
+    glBufferSubData(GL_SHADER_STORAGE_BUFFER, offset * sizeof(PackedFace), faces.size() * sizeof(PackedFace), faces.data());
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+}
+
+void MeshArena::relocate(uint32_t newCapacity) {
+    std::vector<AllocatorMove> moves = allocator.defragment();
+    allocator.grow(newCapacity);
+
+    // Live data is copied into a fresh buffer at its packed offset. Going through a
+    // second buffer avoids overlapping copies within one.
+    GLuint target = 0;
+    if (buffer != 0) {
+        target = createBuffer(static_cast<size_t>(newCapacity) * sizeof(PackedFace));
+        glBindBuffer(GL_COPY_READ_BUFFER, buffer);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, target);
+    }
+
+    for (MeshSlice& slice : slices) {
+        if (slice.faceCount == 0)
+            continue;
+
+        // Moves come out in address order
+        auto move = std::lower_bound(moves.begin(), moves.end(), slice.faceOffset,
+            [](const AllocatorMove& m, uint32_t from) { return m.from < from; });
+        uint32_t newOffset = (move != moves.end() && move->from == slice.faceOffset) ? move->to : slice.faceOffset;
+
+        if (target != 0) {
+            glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER,
+                slice.faceOffset * sizeof(PackedFace), newOffset * sizeof(PackedFace), slice.faceCount * sizeof(PackedFace));
+        }
+        slice.faceOffset = newOffset;
+    }
+
+    if (target != 0) {
+        glBindBuffer(GL_COPY_READ_BUFFER, 0);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+        glDeleteBuffers(1, &buffer);
+        buffer = target;
+    }
+}
+
+GLuint MeshArena::createBuffer(size_t bytes) {
+    GLuint id = 0;
+    glGenBuffers(1, &id);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, id);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, bytes, nullptr, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+    return id;
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <vector>
+#include "Block.h"
+#include "OffsetAllocator.h"
+
+using MeshHandle = uint32_t;
+
+// Where one mesh lives inside the shared buffer, in faces
+struct MeshSlice {
+    uint32_t faceOffset = 0;
+    uint32_t faceCount = 0;
+};
+
+struct MeshArenaStats {
+    AllocatorStats faces;
+    uint32_t meshCount = 0;
+    uint32_t defragmentations = 0;
+    uint32_t growths = 0;
+};
+
+// One face SSBO shared by every chunk mesh. Meshes are addressed by handle, so
+// defragmenting or growing the buffer moves their slices without the owners noticing.
+class MeshArena {
+public:
+    static constexpr MeshHandle INVALID_HANDLE = UINT32_MAX;
+
+    explicit MeshArena(uint32_t faceCapacity);
+
+    // Replaces the mesh behind `handle`, or creates one for INVALID_HANDLE, and returns
+    // the handle to keep using
+    MeshHandle upload(MeshHandle handle, const std::vector<PackedFace>& faces);
+    void release(MeshHandle handle);
+
+    const MeshSlice& getSlice(MeshHandle handle) const { return slices[handle]; }
+
+    // Binds the face buffer to SSBO binding 0
+    void bind() const;
+
+    // Packs the buffer so all free space is at the end
+    void defragment();
+
+    MeshArenaStats getStats() const;
+    void cleanupOpenGLResources();
+
+private:
+    uint32_t allocate(uint32_t count);
+    void write(uint32_t offset, const std::vector<PackedFace>& faces);
+    void relocate(uint32_t newCapacity);
+    static GLuint createBuffer(size_t bytes);
+
+    GLuint buffer = 0;
+    OffsetAllocator allocator;
+    std::vector<MeshSlice> slices;
+    std::vector<MeshHandle> freeHandles;
+    uint32_t defragmentations = 0;
+    uint32_t growths = 0;
+};
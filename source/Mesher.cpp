@@ -0,0 +1,420 @@
+#include "Mesher.h"
+#include <algorithm>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+static constexpr int32_t CHUNK_DIMS[3] = { CHUNK_SIZE, CHUNK_HEIGHT, CHUNK_SIZE };
+
+// Binary mesher layout. X and Z columns hold CHUNK_SIZE bits plus one padding bit on
+// each side, Y columns are split into 64-bit words stored word-plane by word-plane.
+static_assert(CHUNK_SIZE + 2 <= 32, "Padded X/Z occupancy columns must fit in 32 bits");
+static_assert(CHUNK_HEIGHT % 64 == 0, "Y occupancy columns are made of whole 64-bit words");
+static constexpr int32_t COLUMN_WORDS_Y = CHUNK_HEIGHT / 64;
+static constexpr int32_t COLUMNS_XZ = CHUNK_SIZE * CHUNK_HEIGHT;
+static constexpr int32_t COLUMNS_Y = CHUNK_SIZE * CHUNK_SIZE;
+static constexpr uint32_t CHUNK_ROW_MASK = (1u << CHUNK_SIZE) - 1;
+
+static inline uint32_t countTrailingZeros(uint32_t value)
+{
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward(&index, value);
+    return index;
+#else
+    return static_cast<uint32_t>(__builtin_ctz(value));
+#endif
+}
+
+static inline uint32_t countTrailingZeros(uint64_t value)
+{
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward64(&index, value);
+    return index;
+#else
+    return static_cast<uint32_t>(__builtin_ctzll(value));
+#endif
+}
+
+// Faces along a padded X or Z column: a bit is visible towards +/- when its neighbour
+// bit is clear. Results are shifted back to chunk-local bit positions.
+static void detectPaddedFaces(const uint32_t* columns, uint32_t* positive, uint32_t* negative, int32_t count)
+{
+    int32_t i = 0;
+#if defined(__AVX2__)
+    const __m256i rowMask = _mm256_set1_epi32(static_cast<int>(CHUNK_ROW_MASK));
+    for (; i + 8 <= count; i += 8) {
+        __m256i c = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(columns + i));
+        __m256i pos = _mm256_andnot_si256(_mm256_srli_epi32(c, 1), c);
+        __m256i neg = _mm256_andnot_si256(_mm256_slli_epi32(c, 1), c);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(positive + i), _mm256_and_si256(_mm256_srli_epi32(pos, 1), rowMask));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(negative + i), _mm256_and_si256(_mm256_srli_epi32(neg, 1), rowMask));
+    }
+#endif
+    for (; i < count; ++i) {
+        uint32_t c = columns[i];
+        positive[i] = ((c & ~(c >> 1)) >> 1) & CHUNK_ROW_MASK;
+        negative[i] = ((c & ~(c << 1)) >> 1) & CHUNK_ROW_MASK;
+    }
+}
+
+// Faces along the multi-word Y columns, carrying bits across word boundaries.
+// Above the top and below the bottom of the chunk is air.
+static void detectColumnFaces(const uint64_t* columns, uint64_t* top, uint64_t* bottom)
+{
+    for (int32_t w = 0; w < COLUMN_WORDS_Y; ++w) {
+        const uint64_t* current = columns + w * COLUMNS_Y;
+        const uint64_t* above = (w + 1 < COLUMN_WORDS_Y) ? current + COLUMNS_Y : nullptr;
+        const uint64_t* below = (w > 0) ? current - COLUMNS_Y : nullptr;
+        uint64_t* topOut = top + w * COLUMNS_Y;
+        uint64_t* bottomOut = bottom + w * COLUMNS_Y;
+
+        int32_t i = 0;
+#if defined(__AVX2__)
+        const __m256i zero = _mm256_setzero_si256();
+        for (; i + 4 <= COLUMNS_Y; i += 4) {
+            __m256i c = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(current + i));
+            __m256i a = above ? _mm256_loadu_si256(reinterpret_cast<const __m256i*>(above + i)) : zero;
+            __m256i b = below ? _mm256_loadu_si256(reinterpret_cast<const __m256i*>(below + i)) : zero;
+            __m256i up = _mm256_or_si256(_mm256_srli_epi64(c, 1), _mm256_slli_epi64(a, 63));
+            __m256i down = _mm256_or_si256(_mm256_slli_epi64(c, 1), _mm256_srli_epi64(b, 63));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(topOut + i), _mm256_andnot_si256(up, c));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(bottomOut + i), _mm256_andnot_si256(down, c));
+        }
+#endif
+        for (; i < COLUMNS_Y; ++i) {
+            uint64_t c = current[i];
+            uint64_t a = above ? above[i] : 0;
+            uint64_t b = below ? below[i] : 0;
+            topOut[i] = c & ~((c >> 1) | (a << 63));
+            bottomOut[i] = c & ~((c << 1) | (b >> 63));
+        }
+    }
+}
+
+void Mesher::build(MeshingMode mode, const std::vector<BlockType>& blocks, const SectionStates& sections, const ChunkNeighbours& neighbours, std::vector<PackedFace>& faces)
+{
+    switch (mode) {
+    case MeshingMode::GREEDY:
+        buildGreedy(blocks, sections, neighbours, faces);
+        break;
+    case MeshingMode::BINARY:
+        buildBinary(blocks, sections, neighbours, faces);
+        break;
+    case MeshingMode::NAIVE:
+    default:
+        buildNaive(blocks, sections, neighbours, faces);
+        break;
+    }
+}
+
+static bool isNeighbourAir(const ChunkNeighbours& neighbours, NeighbourSide side, int32_t t, int32_t y)
+{
+    // Faces towards neighbours that are not loaded yet stay visible until they are remeshed
+    const std::vector<BlockType>& layer = neighbours.layers[static_cast<int>(side)];
+    return layer.empty() || layer[t + CHUNK_SIZE * y] == BlockType::AIR;
+}
+
+bool Mesher::isFaceVisible(const std::vector<BlockType>& blocks, const ChunkNeighbours& neighbours, int16_t nx, int16_t ny, int16_t nz)
+{
+    if (ny < 0 || ny >= CHUNK_HEIGHT)
+        return true;
+    if (nx < 0)
+        return isNeighbourAir(neighbours, NeighbourSide::NEG_X, nz, ny);
+    if (nx >= CHUNK_SIZE)
+        return isNeighbourAir(neighbours, NeighbourSide::POS_X, nz, ny);
+    if (nz < 0)
+        return isNeighbourAir(neighbours, NeighbourSide::NEG_Z, nx, ny);
+    if (nz >= CHUNK_SIZE)
+        return isNeighbourAir(neighbours, NeighbourSide::POS_Z, nx, ny);
+    return blocks[blockIndex(nx, ny, nz)] == BlockType::AIR;
+}
+
+void Mesher::buildNaive(const std::vector<BlockType>& blocks, const SectionStates& sections, const ChunkNeighbours& neighbours, std::vector<PackedFace>& faces)
+{
+    for (int16_t y = 0; y < CHUNK_HEIGHT; ++y) {
+        if (sections[y / SECTION_HEIGHT] == SectionState::EMPTY) {
+            y += SECTION_HEIGHT - 1;
+            continue;
+        }
+        for (int16_t z = 0; z < CHUNK_SIZE; ++z) {
+            for (int16_t x = 0; x < CHUNK_SIZE; ++x) {
+                const BlockType type = blocks[blockIndex(x, y, z)];
+                if (type == BlockType::AIR) continue;
+
+                glm::vec3 blockPos(x, y, z);
+
+                if (isFaceVisible(blocks, neighbours, x - 1, y, z))
+                    AddFaceToMesh(faces, blockPos, Face::LEFT, type);
+                if (isFaceVisible(blocks, neighbours, x + 1, y, z))
+                    AddFaceToMesh(faces, blockPos, Face::RIGHT, type);
+                if (isFaceVisible(blocks, neighbours, x, y + 1, z))
+                    AddFaceToMesh(faces, blockPos, Face::TOP, type);
+                if (isFaceVisible(blocks, neighbours, x, y - 1, z))
+                    AddFaceToMesh(faces, blockPos, Face::BOTTOM, type);
+                if (isFaceVisible(blocks, neighbours, x, y, z + 1))
+                    AddFaceToMesh(faces, blockPos, Face::FRONT, type);
+                if (isFaceVisible(blocks, neighbours, x, y, z - 1))
+                    AddFaceToMesh(faces, blockPos, Face::BACK, type);
+            }
+        }
+    }
+}
+
+void Mesher::buildGreedy(const std::vector<BlockType>& blocks, const SectionStates& sections, const ChunkNeighbours& neighbours, std::vector<PackedFace>& faces)
+{
+    // Largest slice is CHUNK_SIZE x CHUNK_HEIGHT
+    std::vector<BlockType> mask(CHUNK_SIZE * CHUNK_HEIGHT);
+
+    for (int8_t f = 0; f < 6; ++f) {
+        const Face face = static_cast<Face>(f);
+        const int8_t d = FACE_AXIS[f];
+        const int8_t u = FACE_UV_AXES[f][0];
+        const int8_t v = FACE_UV_AXES[f][1];
+        const int32_t dimU = CHUNK_DIMS[u];
+        const int32_t dimV = CHUNK_DIMS[v];
+
+        for (int32_t slice = 0; slice < CHUNK_DIMS[d]; ++slice) {
+            // Horizontal slices inside an empty section have no faces
+            if (d == 1 && sections[slice / SECTION_HEIGHT] == SectionState::EMPTY)
+                continue;
+
+            // Build the mask of visible faces in this slice
+            int32_t pos[3];
+            pos[d] = slice;
+            for (int32_t j = 0; j < dimV; ++j) {
+                pos[v] = j;
+                if (v == 1 && sections[j / SECTION_HEIGHT] == SectionState::EMPTY) {
+                    std::fill(mask.begin() + j * dimU, mask.begin() + (j + 1) * dimU, BlockType::AIR);
+                    continue;
+                }
+                for (int32_t i = 0; i < dimU; ++i) {
+                    pos[u] = i;
+                    BlockType type = blocks[blockIndex(pos[0], pos[1], pos[2])];
+                    if (type != BlockType::AIR) {
+                        int32_t n[3] = { pos[0], pos[1], pos[2] };
+                        n[d] += FACE_SIGN[f];
+                        if (!isFaceVisible(blocks, neighbours, n[0], n[1], n[2]))
+                            type = BlockType::AIR;
+                    }
+                    mask[i + j * dimU] = type;
+                }
+            }
+
+            // Merge the mask into maximal rectangles, widest first then tallest
+            for (int32_t j = 0; j < dimV; ++j) {
+                for (int32_t i = 0; i < dimU; ) {
+                    const BlockType type = mask[i + j * dimU];
+                    if (type == BlockType::AIR) {
+                        ++i;
+                        continue;
+                    }
+
+                    int32_t width = 1;
+                    while (i + width < dimU && mask[i + width + j * dimU] == type)
+                        ++width;
+
+                    int32_t height = 1;
+                    for (; j + height < dimV; ++height) {
+                        bool rowMatches = true;
+                        for (int32_t k = 0; k < width; ++k) {
+                            if (mask[i + k + (j + height) * dimU] != type) {
+                                rowMatches = false;
+                                break;
+                            }
+                        }
+                        if (!rowMatches)
+                            break;
+                    }
+
+                    glm::vec3 quadPos(0.0f);
+                    quadPos[d] = static_cast<GLfloat>(slice);
+                    quadPos[u] = static_cast<GLfloat>(i);
+                    quadPos[v] = static_cast<GLfloat>(j);
+
+                    glm::vec3 quadSize(1.0f);
+                    quadSize[u] = static_cast<GLfloat>(width);
+                    quadSize[v] = static_cast<GLfloat>(height);
+
+                    AddFaceToMesh(faces, quadPos, face, type, quadSize);
+
+                    for (int32_t h = 0; h < height; ++h)
+                        for (int32_t k = 0; k < width; ++k)
+                            mask[i + k + (j + h) * dimU] = BlockType::AIR;
+
+                    i += width;
+                }
+            }
+        }
+    }
+}
+
+void Mesher::buildBinary(const std::vector<BlockType>& blocks, const SectionStates& sections, const ChunkNeighbours& neighbours, std::vector<PackedFace>& faces)
+{
+    // Occupancy columns
+    std::vector<uint32_t> columnsX(COLUMNS_XZ, 0);                 // [z][y], bit x + 1
+    std::vector<uint32_t> columnsZ(COLUMNS_XZ, 0);                 // [x][y], bit z + 1
+    std::vector<uint64_t> columnsY(COLUMN_WORDS_Y * COLUMNS_Y, 0); // [word][z][x], bit y % 64
+
+    static_assert(64 % SECTION_HEIGHT == 0, "Sections must not straddle Y column words");
+    constexpr uint64_t SECTION_COLUMN_BITS = (SECTION_HEIGHT == 64) ? ~0ull : (1ull << SECTION_HEIGHT) - 1;
+
+    for (int32_t s = 0; s < SECTION_COUNT; ++s) {
+        const int32_t sectionY = s * SECTION_HEIGHT;
+        if (sections[s] == SectionState::EMPTY)
+            continue;
+
+        // Uniform sections are solid throughout, so whole rows and column runs are set at once
+        if (sections[s] == SectionState::UNIFORM) {
+            for (int32_t y = sectionY; y < sectionY + SECTION_HEIGHT; ++y) {
+                for (int32_t t = 0; t < CHUNK_SIZE; ++t) {
+                    columnsX[t * CHUNK_HEIGHT + y] |= CHUNK_ROW_MASK << 1;
+                    columnsZ[t * CHUNK_HEIGHT + y] |= CHUNK_ROW_MASK << 1;
+                }
+            }
+            uint64_t* words = &columnsY[(sectionY >> 6) * COLUMNS_Y];
+            for (int32_t i = 0; i < COLUMNS_Y; ++i)
+                words[i] |= SECTION_COLUMN_BITS << (sectionY & 63);
+            continue;
+        }
+
+        for (int32_t y = sectionY; y < sectionY + SECTION_HEIGHT; ++y) {
+            for (int32_t z = 0; z < CHUNK_SIZE; ++z) {
+                for (int32_t x = 0; x < CHUNK_SIZE; ++x) {
+                    if (blocks[blockIndex(x, y, z)] == BlockType::AIR) continue;
+                    columnsX[z * CHUNK_HEIGHT + y] |= 1u << (x + 1);
+                    columnsZ[x * CHUNK_HEIGHT + y] |= 1u << (z + 1);
+                    columnsY[(y >> 6) * COLUMNS_Y + z * CHUNK_SIZE + x] |= 1ull << (y & 63);
+                }
+            }
+        }
+    }
+
+    // Padding bits carry the neighbours' facing layers so border faces between solid blocks cull
+    auto fillPadding = [&](std::vector<uint32_t>& columns, NeighbourSide side, uint32_t bit) {
+        const std::vector<BlockType>& layer = neighbours.layers[static_cast<int>(side)];
+        if (layer.empty()) return;
+        for (int32_t t = 0; t < CHUNK_SIZE; ++t)
+            for (int32_t y = 0; y < CHUNK_HEIGHT; ++y)
+                if (layer[t + CHUNK_SIZE * y] != BlockType::AIR)
+                    columns[t * CHUNK_HEIGHT + y] |= bit;
+    };
+    fillPadding(columnsX, NeighbourSide::NEG_X, 1u);
+    fillPadding(columnsX, NeighbourSide::POS_X, 1u << (CHUNK_SIZE + 1));
+    fillPadding(columnsZ, NeighbourSide::NEG_Z, 1u);
+    fillPadding(columnsZ, NeighbourSide::POS_Z, 1u << (CHUNK_SIZE + 1));
+
+    // Visible face bits
+    std::vector<uint32_t> facesRight(COLUMNS_XZ), facesLeft(COLUMNS_XZ);
+    std::vector<uint32_t> facesFront(COLUMNS_XZ), facesBack(COLUMNS_XZ);
+    std::vector<uint64_t> facesTop(COLUMN_WORDS_Y * COLUMNS_Y), facesBottom(COLUMN_WORDS_Y * COLUMNS_Y);
+    detectPaddedFaces(columnsX.data(), facesRight.data(), facesLeft.data(), COLUMNS_XZ);
+    detectPaddedFaces(columnsZ.data(), facesFront.data(), facesBack.data(), COLUMNS_XZ);
+    detectColumnFaces(columnsY.data(), facesTop.data(), facesBottom.data());
+
+    // Transpose the face bits into one bit plane per face direction, slice and block type.
+    // Every plane has slices * rows == CHUNK_SIZE * CHUNK_HEIGHT rows of CHUNK_SIZE bits:
+    // X faces: [x][y] bits z, Z faces: [z][y] bits x, Y faces: [y][z] bits x.
+    constexpr int32_t PLANE_ROWS = CHUNK_SIZE * CHUNK_HEIGHT;
+    std::vector<BlockType> planeTypes;
+    std::vector<uint32_t> planes;
+
+    auto planeRow = [&](BlockType type, Face face, int32_t row) -> uint32_t& {
+        size_t slot = 0;
+        while (slot < planeTypes.size() && planeTypes[slot] != type)
+            ++slot;
+        if (slot == planeTypes.size()) {
+            planeTypes.push_back(type);
+            planes.resize(planeTypes.size() * 6 * PLANE_ROWS, 0);
+        }
+        return planes[(slot * 6 + static_cast<size_t>(face)) * PLANE_ROWS + row];
+    };
+
+    for (int32_t z = 0; z < CHUNK_SIZE; ++z) {
+        for (int32_t y = 0; y < CHUNK_HEIGHT; ++y) {
+            for (uint32_t bits = facesRight[z * CHUNK_HEIGHT + y]; bits; bits &= bits - 1) {
+                int32_t x = countTrailingZeros(bits);
+                planeRow(blocks[blockIndex(x, y, z)], Face::RIGHT, x * CHUNK_HEIGHT + y) |= 1u << z;
+            }
+            for (uint32_t bits = facesLeft[z * CHUNK_HEIGHT + y]; bits; bits &= bits - 1) {
+                int32_t x = countTrailingZeros(bits);
+                planeRow(blocks[blockIndex(x, y, z)], Face::LEFT, x * CHUNK_HEIGHT + y) |= 1u << z;
+            }
+        }
+    }
+
+    for (int32_t x = 0; x < CHUNK_SIZE; ++x) {
+        for (int32_t y = 0; y < CHUNK_HEIGHT; ++y) {
+            for (uint32_t bits = facesFront[x * CHUNK_HEIGHT + y]; bits; bits &= bits - 1) {
+                int32_t z = countTrailingZeros(bits);
+                planeRow(blocks[blockIndex(x, y, z)], Face::FRONT, z * CHUNK_HEIGHT + y) |= 1u << x;
+            }
+            for (uint32_t bits = facesBack[x * CHUNK_HEIGHT + y]; bits; bits &= bits - 1) {
+                int32_t z = countTrailingZeros(bits);
+                planeRow(blocks[blockIndex(x, y, z)], Face::BACK, z * CHUNK_HEIGHT + y) |= 1u << x;
+            }
+        }
+    }
+
+    for (int32_t w = 0; w < COLUMN_WORDS_Y; ++w) {
+        for (int32_t z = 0; z < CHUNK_SIZE; ++z) {
+            for (int32_t x = 0; x < CHUNK_SIZE; ++x) {
+                const int32_t column = w * COLUMNS_Y + z * CHUNK_SIZE + x;
+                for (uint64_t bits = facesTop[column]; bits; bits &= bits - 1) {
+                    int32_t y = w * 64 + countTrailingZeros(bits);
+                    planeRow(blocks[blockIndex(x, y, z)], Face::TOP, y * CHUNK_SIZE + z) |= 1u << x;
+                }
+                for (uint64_t bits = facesBottom[column]; bits; bits &= bits - 1) {
+                    int32_t y = w * 64 + countTrailingZeros(bits);
+                    planeRow(blocks[blockIndex(x, y, z)], Face::BOTTOM, y * CHUNK_SIZE + z) |= 1u << x;
+                }
+            }
+        }
+    }
+
+    // Greedy merge each plane: widen along the bit axis with trailing-ones runs,
+    // then grow down the rows while the next row contains the whole run
+    for (size_t slot = 0; slot < planeTypes.size(); ++slot) {
+        for (int8_t f = 0; f < 6; ++f) {
+            const int8_t d = FACE_AXIS[f];
+            const int8_t rowAxis = (d == 1) ? 2 : 1;
+            const int8_t bitAxis = (d == 0) ? 2 : 0;
+            const int32_t rows = CHUNK_DIMS[rowAxis];
+            uint32_t* plane = &planes[(slot * 6 + f) * PLANE_ROWS];
+
+            for (int32_t slice = 0; slice < CHUNK_DIMS[d]; ++slice) {
+                uint32_t* sliceRows = plane + slice * rows;
+                for (int32_t r = 0; r < rows; ++r) {
+                    while (sliceRows[r]) {
+                        const uint32_t start = countTrailingZeros(sliceRows[r]);
+                        const uint32_t width = countTrailingZeros(~(sliceRows[r] >> start));
+                        const uint32_t run = ((1u << width) - 1) << start;
+                        sliceRows[r] &= ~run;
+
+                        int32_t height = 1;
+                        while (r + height < rows && (sliceRows[r + height] & run) == run) {
+                            sliceRows[r + height] &= ~run;
+                            ++height;
+                        }
+
+                        glm::vec3 quadPos(0.0f);
+                        quadPos[d] = static_cast<GLfloat>(slice);
+                        quadPos[rowAxis] = static_cast<GLfloat>(r);
+                        quadPos[bitAxis] = static_cast<GLfloat>(start);
+
+                        glm::vec3 quadSize(1.0f);
+                        quadSize[rowAxis] = static_cast<GLfloat>(height);
+                        quadSize[bitAxis] = static_cast<GLfloat>(width);
+
+                        AddFaceToMesh(faces, quadPos, static_cast<Face>(f), planeTypes[slot], quadSize);
+                    }
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include "Block.h"
+#include "Chunk.h"
+#include <vector>
+
+enum class MeshingMode {
+    NAIVE, GREEDY, BINARY
+};
+
+class Mesher {
+public:
+    // One quad per visible block face
+    static void buildNaive(const std::vector<BlockType>& blocks,
+        const SectionStates& sections,
+        const ChunkNeighbours& neighbours,
+        std::vector<PackedFace>& faces);
+
+    // Merges coplanar visible faces of the same block type into maximal rectangles
+    static void buildGreedy(const std::vector<BlockType>& blocks,
+        const SectionStates& sections,
+        const ChunkNeighbours& neighbours,
+        std::vector<PackedFace>& faces);
+
+    // Greedy meshing on bit columns: visible faces are found with shifts and masks
+    // over the chunk's occupancy (AVX2 when available), then merged per bit row
+    static void buildBinary(const std::vector<BlockType>& blocks,
+        const SectionStates& sections,
+        const ChunkNeighbours& neighbours,
+        std::vector<PackedFace>& faces);
+
+    // Empty sections are skipped by every mesher, uniform ones are filled wholesale
+    // by the binary mesher
+    static void build(MeshingMode mode, const std::vector<BlockType>& blocks,
+        const SectionStates& sections,
+        const ChunkNeighbours& neighbours,
+        std::vector<PackedFace>& faces);
+
+private:
+    static bool isFaceVisible(const std::vector<BlockType>& blocks, const ChunkNeighbours& neighbours, int16_t nx, int16_t ny, int16_t nz);
+};
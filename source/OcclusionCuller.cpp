@@ -0,0 +1,187 @@
+#include "OcclusionCuller.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define OCCLUSION_SSE
+#endif
+
+static_assert(OcclusionCuller::WIDTH % 4 == 0, "Rows are rasterised 4 texels at a time");
+
+// Boxes with a corner closer than this are never culled and never occlude
+static constexpr float NEAR_W = 0.1f;
+
+// The 12 triangles of a box, as indices into the corner order used by projectBox,
+// counter-clockwise when seen from outside
+static constexpr uint8_t BOX_TRIANGLES[12][3] = {
+    { 0, 1, 3 }, { 0, 3, 2 },   // -x
+    { 4, 6, 7 }, { 4, 7, 5 },   // +x
+    { 0, 4, 5 }, { 0, 5, 1 },   // -y
+    { 2, 3, 7 }, { 2, 7, 6 },   // +y
+    { 0, 2, 6 }, { 0, 6, 4 },   // -z
+    { 1, 5, 7 }, { 1, 7, 3 },   // +z
+};
+
+OcclusionCuller::OcclusionCuller() {
+    for (int width = WIDTH, height = HEIGHT; width > 0 && height > 0; width /= 2, height /= 2)
+        levels.emplace_back(static_cast<size_t>(width) * height, std::numeric_limits<float>::infinity());
+}
+
+void OcclusionCuller::begin(const glm::mat4& matrix) {
+    projectionView = matrix;
+    std::fill(levels[0].begin(), levels[0].end(), std::numeric_limits<float>::infinity());
+}
+
+bool OcclusionCuller::projectBox(const glm::vec3& min, const glm::vec3& max, glm::vec2 screen[8], float& nearest, float& farthest) const {
+    nearest = std::numeric_limits<float>::infinity();
+    farthest = 0.0f;
+    for (int i = 0; i < 8; ++i) {
+        glm::vec4 corner((i & 4) ? max.x : min.x, (i & 2) ? max.y : min.y, (i & 1) ? max.z : min.z, 1.0f);
+        glm::vec4 clip = projectionView * corner;
+        if (clip.w < NEAR_W)
+            return false;
+
+        screen[i] = glm::vec2((clip.x / clip.w * 0.5f + 0.5f) * WIDTH, (clip.y / clip.w * 0.5f + 0.5f) * HEIGHT);
+        nearest = std::min(nearest, clip.w);
+        farthest = std::max(farthest, clip.w);
+    }
+    return true;
+}
+
+void OcclusionCuller::addOccluder(const glm::vec3& min, const glm::vec3& max) {
+    glm::vec2 screen[8];
+    float nearest, farthest;
+    if (!projectBox(min, max, screen, nearest, farthest))
+        return;
+
+    // The whole silhouette is written at the box's farthest depth. That can only make
+    // the occluder look further away than it is, never closer.
+    for (const auto& triangle : BOX_TRIANGLES)
+        rasterizeTriangle(screen[triangle[0]], screen[triangle[1]], screen[triangle[2]], farthest);
+}
+
+void OcclusionCuller::rasterizeTriangle(glm::vec2 a, glm::vec2 b, glm::vec2 c, float depth) {
+    // Box triangles wind counter-clockwise seen from outside, so back faces come out
+    // clockwise. The front faces alone already cover the silhouette.
+    float area = (b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x);
+    if (area <= 0.0f)
+        return;
+
+    // Texels whose centre lies inside the bounding box, clamped to the buffer
+    int minX = std::max(0, static_cast<int>(std::ceil(std::min({ a.x, b.x, c.x }) - 0.5f)));
+    int maxX = std::min(WIDTH - 1, static_cast<int>(std::floor(std::max({ a.x, b.x, c.x }) - 0.5f)));
+    int minY = std::max(0, static_cast<int>(std::ceil(std::min({ a.y, b.y, c.y }) - 0.5f)));
+    int maxY = std::min(HEIGHT - 1, static_cast<int>(std::floor(std::max({ a.y, b.y, c.y }) - 0.5f)));
+    if (minX > maxX || minY > maxY)
+        return;
+
+    // Edge functions e(x, y) = stepX * x + stepY * y + offset, positive inside
+    const glm::vec2 edges[3][2] = { { a, b }, { b, c }, { c, a } };
+    float stepX[3], stepY[3], offset[3];
+    for (int e = 0; e < 3; ++e) {
+        glm::vec2 from = edges[e][0], to = edges[e][1];
+        stepX[e] = from.y - to.y;
+        stepY[e] = to.x - from.x;
+        offset[e] = from.x * to.y - from.y * to.x;
+    }
+
+    std::vector<float>& buffer = levels[0];
+    int startX = minX & ~3;
+
+    for (int y = minY; y <= maxY; ++y) {
+        float centerY = y + 0.5f;
+        float* row = buffer.data() + static_cast<size_t>(y) * WIDTH;
+
+#if defined(OCCLUSION_SSE)
+        const __m128 laneOffsets = _mm_set_ps(3.5f, 2.5f, 1.5f, 0.5f);
+        const __m128i laneIndices = _mm_set_epi32(3, 2, 1, 0);
+        const __m128 depthValue = _mm_set1_ps(depth);
+        for (int x = startX; x <= maxX; x += 4) {
+            __m128 centerX = _mm_add_ps(_mm_set1_ps(static_cast<float>(x)), laneOffsets);
+            __m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+            for (int e = 0; e < 3; ++e) {
+                __m128 value = _mm_add_ps(_mm_mul_ps(centerX, _mm_set1_ps(stepX[e])), _mm_set1_ps(stepY[e] * centerY + offset[e]));
+                inside = _mm_and_ps(inside, _mm_cmpgt_ps(value, _mm_setzero_ps()));
+            }
+
+            // Lanes left of minX or right of maxX belong to other triangles' bounds
+            __m128i lane = _mm_add_epi32(_mm_set1_epi32(x), laneIndices);
+            __m128i inRange = _mm_and_si128(_mm_cmpgt_epi32(lane, _mm_set1_epi32(minX - 1)), _mm_cmplt_epi32(lane, _mm_set1_epi32(maxX + 1)));
+            inside = _mm_and_ps(inside, _mm_castsi128_ps(inRange));
+
+            __m128 current = _mm_loadu_ps(row + x);
+            __m128 written = _mm_min_ps(current, depthValue);
+            _mm_storeu_ps(row + x, _mm_or_ps(_mm_and_ps(inside, written), _mm_andnot_ps(inside, current)));
+        }
+#else
+        for (int x = minX; x <= maxX; ++x) {
+            float centerX = x + 0.5f;
+            bool inside = true;
+            for (int e = 0; e < 3; ++e)
+                inside = inside && stepX[e] * centerX + stepY[e] * centerY + offset[e] > 0.0f;
+            if (inside)
+                row[x] = std::min(row[x], depth);
+        }
+#endif
+    }
+}
+
+void OcclusionCuller::finish() {
+    for (size_t level = 1; level < levels.size(); ++level) {
+        int width = WIDTH >> level, height = HEIGHT >> level;
+        int sourceWidth = width * 2;
+        const std::vector<float>& source = levels[level - 1];
+        std::vector<float>& target = levels[level];
+
+        for (int y = 0; y < height; ++y) {
+            const float* top = source.data() + static_cast<size_t>(y * 2) * sourceWidth;
+            const float* bottom = top + sourceWidth;
+            for (int x = 0; x < width; ++x) {
+                target[static_cast<size_t>(y) * width + x] = std::max(
+                    std::max(top[x * 2], top[x * 2 + 1]),
+                    std::max(bottom[x * 2], bottom[x * 2 + 1]));
+            }
+        }
+    }
+}
+
+bool OcclusionCuller::isVisible(const glm::vec3& min, const glm::vec3& max) const {
+    glm::vec2 screen[8];
+    float nearest, farthest;
+    if (!projectBox(min, max, screen, nearest, farthest))
+        return true;
+
+    glm::vec2 low = screen[0], high = screen[0];
+    for (int i = 1; i < 8; ++i) {
+        low = glm::min(low, screen[i]);
+        high = glm::max(high, screen[i]);
+    }
+    if (high.x < 0.0f || high.y < 0.0f || low.x >= WIDTH || low.y >= HEIGHT)
+        return true;    // Off screen, the frustum test decides about these
+
+    // Every texel the box's screen rectangle touches
+    int minX = std::max(0, static_cast<int>(std::floor(low.x)));
+    int maxX = std::min(WIDTH - 1, static_cast<int>(std::floor(high.x)));
+    int minY = std::max(0, static_cast<int>(std::floor(low.y)));
+    int maxY = std::min(HEIGHT - 1, static_cast<int>(std::floor(high.y)));
+
+    // Go up the pyramid until the rectangle is at most 4x4 texels
+    size_t level = 0;
+    while (level + 1 < levels.size() && (maxX - minX > 3 || maxY - minY > 3)) {
+        ++level;
+        minX >>= 1; maxX >>= 1;
+        minY >>= 1; maxY >>= 1;
+    }
+
+    int width = WIDTH >> level;
+    const std::vector<float>& depths = levels[level];
+    for (int y = minY; y <= maxY; ++y) {
+        for (int x = minX; x <= maxX; ++x) {
+            if (depths[static_cast<size_t>(y) * width + x] >= nearest)
+                return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <glm.hpp>
+#include <cstdint>
+#include <vector>
+
+// Software occlusion culling on a small depth buffer. Boxes known to be completely
+// solid are rasterised as occluders at their farthest depth, then a max-depth pyramid
+// of the buffer is built and other boxes are tested against it. Everything is
+// conservative: a box is only reported hidden if it is behind occluders in every
+// texel it covers. Runs entirely on the CPU, no GL involved.
+class OcclusionCuller {
+public:
+    static constexpr int WIDTH = 256;
+    static constexpr int HEIGHT = 128;
+
+    OcclusionCuller();
+
+    // Clears the depth buffer for a new frame
+    void begin(const glm::mat4& projectionView);
+
+    // Box that is solid all the way through. Skipped when it crosses the near plane.
+    void addOccluder(const glm::vec3& min, const glm::vec3& max);
+
+    // Builds the depth pyramid, call after the last occluder
+    void finish();
+
+    bool isVisible(const glm::vec3& min, const glm::vec3& max) const;
+
+    const std::vector<float>& getDepthBuffer() const { return levels[0]; }
+
+private:
+    // Projects the 8 corners, false if any is too close to or behind the camera
+    bool projectBox(const glm::vec3& min, const glm::vec3& max, glm::vec2 screen[8], float& nearest, float& farthest) const;
+    void rasterizeTriangle(glm::vec2 a, glm::vec2 b, glm::vec2 c, float depth);
+
+    glm::mat4 projectionView{ 1.0f };
+
+    // Level 0 is the depth buffer, every next level holds the max of 2x2 texels.
+    // Depth is clip-space w, so smaller is nearer and empty texels are +inf.
+    std::vector<std::vector<float>> levels;
+};
@@ -0,0 +1,133 @@
+#include "OffsetAllocator.h"
+
+OffsetAllocator::OffsetAllocator(uint32_t initialCapacity) : capacity(initialCapacity) {
+    if (capacity > 0)
+        insertFreeBlock(0, capacity);
+}
+
+uint32_t OffsetAllocator::allocate(uint32_t size) {
+    if (size == 0)
+        return INVALID_OFFSET;
+
+    // Smallest free block that fits
+    auto fit = freeBySize.lower_bound(size);
+    if (fit == freeBySize.end())
+        return INVALID_OFFSET;
+
+    uint32_t offset = fit->second;
+    uint32_t blockSize = fit->first;
+    eraseFreeBlock(freeByOffset.find(offset));
+
+    if (blockSize > size)
+        insertFreeBlock(offset + size, blockSize - size);
+
+    allocations.emplace(offset, size);
+    used += size;
+    return offset;
+}
+
+void OffsetAllocator::free(uint32_t offset) {
+    auto allocation = allocations.find(offset);
+    if (allocation == allocations.end())
+        return;
+
+    uint32_t size = allocation->second;
+    allocations.erase(allocation);
+    used -= size;
+
+    // Merge with the free blocks directly after and before
+    auto next = freeByOffset.find(offset + size);
+    if (next != freeByOffset.end()) {
+        size += next->second;
+        eraseFreeBlock(next);
+    }
+
+    auto previous = freeByOffset.lower_bound(offset);
+    if (previous != freeByOffset.begin()) {
+        --previous;
+        if (previous->first + previous->second == offset) {
+            offset = previous->first;
+            size += previous->second;
+            eraseFreeBlock(previous);
+        }
+    }
+
+    insertFreeBlock(offset, size);
+}
+
+void OffsetAllocator::grow(uint32_t newCapacity) {
+    if (newCapacity <= capacity)
+        return;
+
+    uint32_t offset = capacity;
+    uint32_t size = newCapacity - capacity;
+    capacity = newCapacity;
+
+    // Extend a free block that ends at the old capacity instead of adding a second one
+    if (!freeByOffset.empty()) {
+        auto last = std::prev(freeByOffset.end());
+        if (last->first + last->second == offset) {
+            offset = last->first;
+            size += last->second;
+            eraseFreeBlock(last);
+        }
+    }
+
+    insertFreeBlock(offset, size);
+}
+
+std::vector<AllocatorMove> OffsetAllocator::defragment() {
+    std::vector<AllocatorMove> moves;
+
+    // Allocations are visited in address order, so every range only ever moves down
+    // and never over one that has not been moved yet
+    std::map<uint32_t, uint32_t> packed;
+    uint32_t cursor = 0;
+    for (const auto& [offset, size] : allocations) {
+        if (offset != cursor)
+            moves.push_back({ offset, cursor, size });
+        packed.emplace_hint(packed.end(), cursor, size);
+        cursor += size;
+    }
+
+    allocations = std::move(packed);
+    freeByOffset.clear();
+    freeBySize.clear();
+    if (cursor < capacity)
+        insertFreeBlock(cursor, capacity - cursor);
+
+    return moves;
+}
+
+uint32_t OffsetAllocator::sizeOf(uint32_t offset) const {
+    auto allocation = allocations.find(offset);
+    return allocation == allocations.end() ? 0 : allocation->second;
+}
+
+AllocatorStats OffsetAllocator::getStats() const {
+    AllocatorStats stats;
+    stats.capacity = capacity;
+    stats.used = used;
+    stats.allocationCount = static_cast<uint32_t>(allocations.size());
+    stats.freeBlockCount = static_cast<uint32_t>(freeByOffset.size());
+    if (!freeBySize.empty())
+        stats.largestFreeBlock = std::prev(freeBySize.end())->first;
+    return stats;
+}
+
+void OffsetAllocator::insertFreeBlock(uint32_t offset, uint32_t size) {
+    freeByOffset.emplace(offset, size);
+    freeBySize.emplace(size, offset);
+}
+
+void OffsetAllocator::eraseFreeBlock(std::map<uint32_t, uint32_t>::iterator block) {
+    // Several blocks can share a size, find the one with this offset
+    auto range = freeBySize.equal_range(block->second);
+    for (auto it = range.first; it != range.second; ++it) {
+        if (it->second == block->first) {
+            freeBySize.erase(it);
+            break;
+        }
+    }
+    freeByOffset.erase(block);
+}
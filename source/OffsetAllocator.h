@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstdint>
+#include <iterator>
+#include <map>
+#include <vector>
+
+// A live range that defragment() moved, in the allocator's units
+struct AllocatorMove {
+    uint32_t from;
+    uint32_t to;
+    uint32_t size;
+};
+
+struct AllocatorStats {
+    uint32_t capacity = 0;
+    uint32_t used = 0;
+    uint32_t allocationCount = 0;
+    uint32_t freeBlockCount = 0;
+    uint32_t largestFreeBlock = 0;
+
+    // 0 when all free space is one block, approaching 1 as it splinters
+    float fragmentation() const {
+        uint32_t freeSpace = capacity - used;
+        return freeSpace == 0 ? 0.0f : 1.0f - static_cast<float>(largestFreeBlock) / freeSpace;
+    }
+};
+
+// Hands out ranges of [0, capacity) for a buffer that lives somewhere else, typically
+// on the GPU. Best fit over a size-ordered free list, neighbouring free blocks are
+// merged on free. Knows nothing about GL so it can be tested on its own.
+class OffsetAllocator {
+public:
+    static constexpr uint32_t INVALID_OFFSET = UINT32_MAX;
+
+    explicit OffsetAllocator(uint32_t initialCapacity = 0);
+
+    // Offset of a free range of `size` units, INVALID_OFFSET if no free block is large enough
+    uint32_t allocate(uint32_t size);
+    void free(uint32_t offset);
+
+    // Adds space at the end, existing offsets stay valid
+    void grow(uint32_t newCapacity);
+
+    // Packs every live allocation towards offset 0, keeping their order, and returns the
+    // moves the owner of the buffer has to replay. Afterwards all free space is one block.
+    std::vector<AllocatorMove> defragment();
+
+    uint32_t sizeOf(uint32_t offset) const;
+    uint32_t getCapacity() const { return capacity; }
+    AllocatorStats getStats() const;
+
+private:
+    void insertFreeBlock(uint32_t offset, uint32_t size);
+    void eraseFreeBlock(std::map<uint32_t, uint32_t>::iterator block);
+
+    uint32_t capacity;
+    uint32_t used = 0;
+    std::map<uint32_t, uint32_t> freeByOffset;          // offset -> size, for merging
+    std::multimap<uint32_t, uint32_t> freeBySize;       // size -> offset, for best fit
+    std::map<uint32_t, uint32_t> allocations;           // offset -> size
+};
@@ -0,0 +1,274 @@
+#include "RegionFile.h"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+static_assert(sizeof(RegionHeader) == 16 + REGION_CHUNKS * sizeof(RegionEntry), "RegionHeader must not be padded");
+
+static constexpr char REGION_MAGIC[4] = { 'V', 'X', 'R', 'G' };
+
+// Payloads holding a type at or above this are corrupt or come from a newer build
+static constexpr uint32_t BLOCK_TYPE_COUNT = static_cast<uint32_t>(BlockType::COUNT);
+
+// Region files can grow past 2 GB, more than fseek's long can address on Windows
+static bool seekTo(FILE* file, uint64_t offset)
+{
+#ifdef _WIN32
+    return _fseeki64(file, static_cast<__int64>(offset), SEEK_SET) == 0;
+#else
+    return fseeko(file, static_cast<off_t>(offset), SEEK_SET) == 0;
+#endif
+}
+
+static void writeVarint(std::vector<uint8_t>& out, uint32_t value)
+{
+    while (value >= 0x80) {
+        out.push_back(static_cast<uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(value));
+}
+
+static bool readVarint(const uint8_t*& data, const uint8_t* end, uint32_t& value)
+{
+    value = 0;
+    for (uint32_t shift = 0; shift < 35 && data < end; shift += 7) {
+        uint8_t byte = *data++;
+        value |= static_cast<uint32_t>(byte & 0x7F) << shift;
+        if (!(byte & 0x80))
+            return true;
+    }
+    return false;
+}
+
+void encodeChunk(const ChunkBlocks& blocks, std::vector<uint8_t>& out)
+{
+    std::vector<BlockType> dense;
+    blocks.unpack(dense);
+
+    out.clear();
+    size_t runStart = 0;
+    for (size_t i = 1; i <= dense.size(); ++i) {
+        if (i < dense.size() && dense[i] == dense[runStart])
+            continue;
+        writeVarint(out, static_cast<uint32_t>(i - runStart));
+        writeVarint(out, static_cast<uint32_t>(dense[runStart]));
+        runStart = i;
+    }
+}
+
+bool decodeChunk(const uint8_t* data, size_t size, ChunkBlocks& blocks)
+{
+    std::vector<BlockType> dense;
+    dense.reserve(CHUNK_VOLUME);
+
+    const uint8_t* end = data + size;
+    while (data < end) {
+        uint32_t length, type;
+        if (!readVarint(data, end, length) || !readVarint(data, end, type))
+            return false;
+        if (length == 0 || dense.size() + length > CHUNK_VOLUME || type >= BLOCK_TYPE_COUNT)
+            return false;
+        dense.insert(dense.end(), length, static_cast<BlockType>(type));
+    }
+    if (dense.size() != CHUNK_VOLUME)
+        return false;
+
+    blocks = ChunkBlocks(dense);
+    return true;
+}
+
+bool RegionFile::createEmpty(const std::filesystem::path& filePath)
+{
+    FILE* created = std::fopen(filePath.string().c_str(), "wb");
+    if (!created)
+        return false;
+
+    RegionHeader empty{};
+    std::memcpy(empty.magic, REGION_MAGIC, sizeof(REGION_MAGIC));
+    empty.version = VERSION;
+    bool written = std::fwrite(&empty, sizeof(empty), 1, created) == 1;
+    std::fclose(created);
+    return written;
+}
+
+bool RegionFile::open(const std::filesystem::path& filePath)
+{
+    close();
+    path = filePath;
+
+    std::error_code error;
+    if (!std::filesystem::exists(path, error) && !createEmpty(path))
+        return false;
+
+    fileSize = std::filesystem::file_size(path, error);
+    if (error || fileSize < sizeof(RegionHeader)) {
+        std::cerr << "Region file " << path.string() << " is truncated" << std::endl;
+        return false;
+    }
+
+    file = std::fopen(path.string().c_str(), "r+b");
+    if (!file || !mappedHeader.map(path.string(), sizeof(RegionHeader))) {
+        close();
+        return false;
+    }
+
+    if (std::memcmp(header().magic, REGION_MAGIC, sizeof(REGION_MAGIC)) != 0 || header().version != VERSION) {
+        std::cerr << "Region file " << path.string() << " has an unknown format" << std::endl;
+        close();
+        return false;
+    }
+
+    liveBytes = 0;
+    for (const RegionEntry& entry : header().entries)
+        liveBytes += entry.size;
+    garbageBytes = fileSize - sizeof(RegionHeader) - liveBytes;
+    return true;
+}
+
+void RegionFile::close()
+{
+    mappedHeader.unmap();
+    if (file) {
+        std::fclose(file);
+        file = nullptr;
+    }
+}
+
+bool RegionFile::read(int32_t index, std::vector<uint8_t>& payload)
+{
+    const RegionEntry entry = header().entries[index];
+    if (entry.size == 0 || static_cast<uint64_t>(entry.offset) + entry.size > fileSize)
+        return false;
+
+    payload.resize(entry.size);
+    return seekTo(file, entry.offset)
+        && std::fread(payload.data(), 1, payload.size(), file) == payload.size();
+}
+
+size_t RegionFile::readBatch(const std::vector<int32_t>& indices, std::vector<std::vector<uint8_t>>& payloads, std::vector<bool>& failed)
+{
+    payloads.assign(indices.size(), {});
+    failed.assign(indices.size(), false);
+
+    // Positions in `indices` of the stored chunks, sorted by where their payload starts.
+    // An entry pointing past the end of the file is saved but unreadable.
+    std::vector<size_t> order;
+    order.reserve(indices.size());
+    for (size_t i = 0; i < indices.size(); ++i) {
+        const RegionEntry& entry = header().entries[indices[i]];
+        if (entry.size == 0)
+            continue;
+        if (static_cast<uint64_t>(entry.offset) + entry.size <= fileSize)
+            order.push_back(i);
+        else
+            failed[i] = true;
+    }
+    std::sort(order.begin(), order.end(), [this, &indices](size_t a, size_t b) {
+        return header().entries[indices[a]].offset < header().entries[indices[b]].offset;
+        });
+
+    size_t reads = 0;
+    std::vector<uint8_t> span;
+    for (size_t first = 0; first < order.size();) {
+        const uint32_t start = header().entries[indices[order[first]]].offset;
+        uint64_t end = start + header().entries[indices[order[first]]].size;
+
+        size_t last = first + 1;
+        for (; last < order.size(); ++last) {
+            const RegionEntry& next = header().entries[indices[order[last]]];
+            uint64_t nextEnd = static_cast<uint64_t>(next.offset) + next.size;
+            if (next.offset > end + MAX_READ_GAP || std::max(end, nextEnd) - start > MAX_READ_SPAN)
+                break;
+            end = std::max(end, nextEnd);
+        }
+
+        span.resize(static_cast<size_t>(end - start));
+        ++reads;
+        bool spanRead = seekTo(file, start) && std::fread(span.data(), 1, span.size(), file) == span.size();
+        if (!spanRead)
+            std::clearerr(file);
+        for (size_t k = first; k < last; ++k) {
+            if (!spanRead) {
+                failed[order[k]] = true;
+                continue;
+            }
+            const RegionEntry& entry = header().entries[indices[order[k]]];
+            const uint8_t* payload = span.data() + (entry.offset - start);
+            payloads[order[k]].assign(payload, payload + entry.size);
+        }
+        first = last;
+    }
+    return reads;
+}
+
+bool RegionFile::writeBatch(const std::vector<std::pair<int32_t, const std::vector<uint8_t>*>>& payloads)
+{
+    std::vector<uint8_t> buffer;
+    for (const auto& [index, payload] : payloads)
+        buffer.insert(buffer.end(), payload->begin(), payload->end());
+    if (buffer.empty() || fileSize + buffer.size() > UINT32_MAX)
+        return false;
+
+    // Payloads are on disk before the table points at them, so a crash in between only
+    // leaves garbage behind
+    if (!seekTo(file, fileSize)
+        || std::fwrite(buffer.data(), 1, buffer.size(), file) != buffer.size()
+        || std::fflush(file) != 0)
+        return false;
+
+    uint64_t offset = fileSize;
+    for (const auto& [index, payload] : payloads) {
+        RegionEntry& entry = header().entries[index];
+        garbageBytes += entry.size;
+        liveBytes += payload->size() - entry.size;
+        entry = { static_cast<uint32_t>(offset), static_cast<uint32_t>(payload->size()) };
+        offset += payload->size();
+    }
+    fileSize += buffer.size();
+
+    // Starts writing the table back now rather than whenever the OS gets to it
+    mappedHeader.flush();
+    return true;
+}
+
+bool RegionFile::compact()
+{
+    std::filesystem::path compactedPath = path;
+    compactedPath += ".tmp";
+
+    FILE* compacted = std::fopen(compactedPath.string().c_str(), "wb");
+    if (!compacted)
+        return false;
+
+    // Same table with every offset moved to the packed position
+    RegionHeader packedHeader = header();
+    uint32_t cursor = sizeof(RegionHeader);
+    bool written = std::fwrite(&packedHeader, sizeof(packedHeader), 1, compacted) == 1;
+
+    std::vector<uint8_t> payload;
+    for (int32_t i = 0; i < REGION_CHUNKS && written; ++i) {
+        if (!contains(i))
+            continue;
+        written = read(i, payload) && std::fwrite(payload.data(), 1, payload.size(), compacted) == payload.size();
+        packedHeader.entries[i].offset = cursor;
+        cursor += static_cast<uint32_t>(payload.size());
+    }
+
+    written = written && std::fseek(compacted, 0, SEEK_SET) == 0
+        && std::fwrite(&packedHeader, sizeof(packedHeader), 1, compacted) == 1;
+    std::fclose(compacted);
+
+    std::error_code error;
+    if (!written) {
+        std::filesystem::remove(compactedPath, error);
+        return false;
+    }
+
+    // The mapping has to go before the file can be replaced
+    close();
+    std::filesystem::rename(compactedPath, path, error);
+    if (error)
+        std::cerr << "Failed to replace region file " << path.string() << ": " << error.message() << std::endl;
+    return open(path) && !error;
+}
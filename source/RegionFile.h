@@ -0,0 +1,102 @@
+#pragma once
+
+#include "ChunkStorage.h"
+#include "MappedFile.h"
+#include <cstdio>
+#include <filesystem>
+#include <utility>
+#include <vector>
+
+constexpr int32_t REGION_SIZE = 32;                     // Chunks along x and z in one region file
+constexpr int32_t REGION_CHUNKS = REGION_SIZE * REGION_SIZE;
+
+// Where a chunk's payload lives in its region file, size 0 when it was never saved
+struct RegionEntry {
+    uint32_t offset;
+    uint32_t size;
+};
+
+// Fixed-size table at the start of every region file, indexed by regionChunkIndex
+struct RegionHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t reserved[2];
+    RegionEntry entries[REGION_CHUNKS];
+};
+
+inline std::pair<int, int> regionOf(const std::pair<int, int>& chunkCoord)
+{
+    auto floorDiv = [](int value) { return (value >= 0 ? value : value - REGION_SIZE + 1) / REGION_SIZE; };
+    return { floorDiv(chunkCoord.first), floorDiv(chunkCoord.second) };
+}
+
+inline int32_t regionChunkIndex(const std::pair<int, int>& chunkCoord)
+{
+    return (chunkCoord.first & (REGION_SIZE - 1)) + REGION_SIZE * (chunkCoord.second & (REGION_SIZE - 1));
+}
+
+// Run-length encodes the dense y-major blocks as (run length, type) pairs of LEB128
+// varints. Terrain is mostly long runs of air and stone, a chunk usually fits in a few KB.
+void encodeChunk(const ChunkBlocks& blocks, std::vector<uint8_t>& out);
+
+// False if the payload is truncated, does not add up to a whole chunk or holds a block type
+// this build does not know. Callers must not save over such a chunk, it may be valid for a
+// newer build.
+bool decodeChunk(const uint8_t* data, size_t size, ChunkBlocks& blocks);
+
+// One file holding up to REGION_SIZE x REGION_SIZE chunks. The header table is read and
+// updated through a memory mapping, payloads are only ever appended, so a chunk that is
+// saved again leaves its old payload behind as garbage until the file is compacted.
+// Not thread-safe, RegionStore serialises access.
+class RegionFile {
+public:
+    static constexpr uint32_t VERSION = 1;
+    // Compact once garbage outweighs live data and is at least this large
+    static constexpr uint64_t MIN_COMPACTION_GARBAGE = 1 << 20;
+    // Payloads closer than this share one read in readBatch, up to MAX_READ_SPAN bytes
+    static constexpr uint32_t MAX_READ_GAP = 16 * 1024;
+    static constexpr uint32_t MAX_READ_SPAN = 1 << 20;
+
+    RegionFile() = default;
+    ~RegionFile() { close(); }
+
+    RegionFile(const RegionFile&) = delete;
+    RegionFile& operator=(const RegionFile&) = delete;
+
+    // Opens the file, creating it with an empty table if it does not exist
+    bool open(const std::filesystem::path& filePath);
+    void close();
+    // False after close() or a failed open(), nothing but open() may be called then
+    bool isOpen() const { return mappedHeader.isMapped(); }
+
+    bool contains(int32_t index) const { return header().entries[index].size > 0; }
+    bool read(int32_t index, std::vector<uint8_t>& payload);
+
+    // Reads the payloads of every index in file order, coalescing nearby ones into a
+    // single read. Chunks that were never saved come back empty, ones that are saved but
+    // could not be read are flagged in `failed`. Returns the reads made.
+    size_t readBatch(const std::vector<int32_t>& indices, std::vector<std::vector<uint8_t>>& payloads, std::vector<bool>& failed);
+
+    // Appends every payload with one write and one flush, then points the table at them
+    // and flushes the mapped table
+    bool writeBatch(const std::vector<std::pair<int32_t, const std::vector<uint8_t>*>>& payloads);
+
+    bool needsCompaction() const { return garbageBytes > liveBytes && garbageBytes >= MIN_COMPACTION_GARBAGE; }
+    // Rewrites the file with only the live payloads, back to back. The file is closed
+    // if it cannot be reopened afterwards.
+    bool compact();
+
+    uint64_t getLiveBytes() const { return liveBytes; }
+    uint64_t getGarbageBytes() const { return garbageBytes; }
+
+private:
+    RegionHeader& header() const { return *reinterpret_cast<RegionHeader*>(mappedHeader.data()); }
+    bool createEmpty(const std::filesystem::path& filePath);
+
+    std::filesystem::path path;
+    FILE* file = nullptr;
+    MappedFile mappedHeader;
+    uint64_t fileSize = 0;
+    uint64_t liveBytes = 0;
+    uint64_t garbageBytes = 0;
+};
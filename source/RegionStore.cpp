@@ -0,0 +1,188 @@
+#include "RegionStore.h"
+#include <iostream>
+#include <string>
+
+RegionStore::RegionStore(std::filesystem::path saveDirectory) : directory(std::move(saveDirectory)) {
+    std::error_code error;
+    std::filesystem::create_directories(directory, error);
+    if (error)
+        std::cerr << "Failed to create save directory " << directory.string() << ": " << error.message() << std::endl;
+}
+
+uint64_t RegionStore::queueSave(const std::pair<int, int>& chunkCoord, const ChunkBlocks& blocks) {
+    auto snapshot = std::make_shared<const ChunkBlocks>(blocks);
+
+    std::lock_guard<std::mutex> lock(mutex);
+    uint64_t ticket = nextTicket++;
+    queuedSaves[chunkCoord] = { ticket, std::move(snapshot) };
+    return ticket;
+}
+
+std::shared_ptr<const ChunkBlocks> RegionStore::getQueuedSave(const std::pair<int, int>& chunkCoord, uint64_t ticket) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto queued = queuedSaves.find(chunkCoord);
+    if (queued == queuedSaves.end() || queued->second.ticket != ticket)
+        return nullptr;
+    return queued->second.blocks;
+}
+
+void RegionStore::readBatch(const std::vector<ChunkRead*>& reads) {
+    // Saves that have not reached the disk yet are newer than anything in the files
+    std::map<std::pair<int, int>, std::vector<ChunkRead*>> byRegion;
+    size_t loaded = 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (ChunkRead* read : reads) {
+            auto queued = queuedSaves.find(read->coord);
+            if (queued != queuedSaves.end()) {
+                read->result.queuedBlocks = queued->second.blocks;
+                ++loaded;
+            }
+            else {
+                byRegion[regionOf(read->coord)].push_back(read);
+            }
+        }
+    }
+
+    size_t diskReads = 0;
+    std::vector<int32_t> indices;
+    std::vector<std::vector<uint8_t>> payloads;
+    std::vector<bool> failed;
+    for (auto& [regionCoord, regionReads] : byRegion) {
+        // Any chunk of a region that cannot be opened might be saved in it
+        RegionFile* region = openRegion(regionCoord);
+        if (!region) {
+            for (ChunkRead* read : regionReads)
+                read->result.error = true;
+            continue;
+        }
+
+        indices.clear();
+        for (const ChunkRead* read : regionReads)
+            indices.push_back(regionChunkIndex(read->coord));
+        diskReads += region->readBatch(indices, payloads, failed);
+
+        for (size_t i = 0; i < regionReads.size(); ++i) {
+            if (failed[i]) {
+                regionReads[i]->result.error = true;
+                continue;
+            }
+            if (payloads[i].empty())
+                continue;
+            regionReads[i]->result.payload = std::move(payloads[i]);
+            ++loaded;
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    stats.loadedChunks += loaded;
+    stats.diskReads += diskReads;
+    stats.openRegions = regions.size();
+}
+
+void RegionStore::writeBatch(std::vector<ChunkWrite>& writes, std::vector<ChunkWrite>& failed) {
+    // A save replaced while it was being encoded is skipped, the newer one follows
+    std::map<std::pair<int, int>, std::vector<ChunkWrite*>> byRegion;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (ChunkWrite& write : writes) {
+            auto queued = queuedSaves.find(write.coord);
+            if (queued != queuedSaves.end() && queued->second.ticket == write.ticket && !write.payload.empty())
+                byRegion[regionOf(write.coord)].push_back(&write);
+        }
+    }
+
+    std::vector<std::pair<int32_t, const std::vector<uint8_t>*>> payloads;
+    for (auto& [regionCoord, regionWrites] : byRegion) {
+        RegionFile* region = openRegion(regionCoord);
+
+        payloads.clear();
+        for (const ChunkWrite* write : regionWrites)
+            payloads.emplace_back(regionChunkIndex(write->coord), &write->payload);
+
+        if (!region || !region->writeBatch(payloads)) {
+            std::cerr << "Failed to save " << regionWrites.size() << " chunks to region "
+                << regionCoord.first << ", " << regionCoord.second << std::endl;
+            for (ChunkWrite* write : regionWrites)
+                failed.push_back(std::move(*write));
+            continue;
+        }
+
+        bool compacted = region->needsCompaction() && region->compact();
+        // The payloads are already on disk, but a file that failed to reopen is closed
+        if (!region->isOpen())
+            regions.erase(regionCoord);
+
+        std::lock_guard<std::mutex> lock(mutex);
+        for (const ChunkWrite* write : regionWrites) {
+            // Queued again since the batch started, that save still has to be written
+            auto queued = queuedSaves.find(write->coord);
+            if (queued != queuedSaves.end() && queued->second.ticket == write->ticket)
+                queuedSaves.erase(queued);
+            ++stats.savedChunks;
+            stats.bytesWritten += write->payload.size();
+        }
+        if (compacted)
+            ++stats.compactions;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    stats.openRegions = regions.size();
+}
+
+size_t RegionStore::flushQueuedSaves() {
+    std::vector<ChunkWrite> writes;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (const auto& [chunkCoord, save] : queuedSaves) {
+            writes.push_back({ chunkCoord, save.ticket, {} });
+            encodeChunk(*save.blocks, writes.back().payload);
+        }
+    }
+    if (writes.empty())
+        return 0;
+
+    std::vector<ChunkWrite> failed;
+    writeBatch(writes, failed);
+    if (!failed.empty())
+        std::cerr << failed.size() << " chunks could not be saved and are lost" << std::endl;
+    return failed.size();
+}
+
+RegionStoreStats RegionStore::getStats() {
+    std::lock_guard<std::mutex> lock(mutex);
+    RegionStoreStats current = stats;
+    current.queuedSaves = queuedSaves.size();
+    return current;
+}
+
+RegionFile* RegionStore::openRegion(const std::pair<int, int>& regionCoord) {
+    auto found = regions.find(regionCoord);
+    if (found != regions.end()) {
+        if (found->second.file->isOpen()) {
+            found->second.lastUse = ++useCounter;
+            return found->second.file.get();
+        }
+        regions.erase(found);
+    }
+
+    if (regions.size() >= MAX_OPEN_REGIONS) {
+        auto oldest = regions.begin();
+        for (auto it = regions.begin(); it != regions.end(); ++it) {
+            if (it->second.lastUse < oldest->second.lastUse)
+                oldest = it;
+        }
+        regions.erase(oldest);
+    }
+
+    auto file = std::make_unique<RegionFile>();
+    std::string name = "r." + std::to_string(regionCoord.first) + "." + std::to_string(regionCoord.second) + ".vxr";
+    if (!file->open(directory / name)) {
+        std::cerr << "Failed to open region file " << (directory / name).string() << std::endl;
+        return nullptr;
+    }
+
+    RegionFile* region = file.get();
+    regions.emplace(regionCoord, OpenRegion{ std::move(file), ++useCounter });
+    return region;
+}
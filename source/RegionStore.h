@@ -0,0 +1,96 @@
+#pragma once
+
+#include "RegionFile.h"
+#include <map>
+#include <memory>
+#include <mutex>
+
+struct RegionStoreStats {
+    size_t loadedChunks = 0;
+    size_t savedChunks = 0;
+    size_t queuedSaves = 0;
+    size_t diskReads = 0;                               // Reads issued, several chunks can share one
+    size_t openRegions = 0;
+    size_t compactions = 0;
+    uint64_t bytesWritten = 0;
+};
+
+// What a chunk read found, both empty when the chunk was never saved or could not be read
+struct ChunkReadResult {
+    std::shared_ptr<const ChunkBlocks> queuedBlocks;    // A save that has not reached the disk yet
+    std::vector<uint8_t> payload;                       // Encoded blocks, see decodeChunk
+    bool error = false;                                 // The region or payload could not be read, the chunk may still be saved
+
+    bool found() const { return queuedBlocks || !payload.empty(); }
+};
+
+struct ChunkRead {
+    std::pair<int, int> coord;
+    ChunkReadResult result;
+};
+
+struct ChunkWrite {
+    std::pair<int, int> coord;
+    uint64_t ticket;                                    // From queueSave
+    std::vector<uint8_t> payload;
+    uint32_t attempts = 0;                              // Earlier writeBatch calls that failed it
+};
+
+// Chunks saved to region files in one directory. Saves are queued from any thread and
+// are visible to reads right away, so a chunk that comes back into range before its
+// save reached the disk is never regenerated from noise. The region files themselves
+// are only touched by readBatch and writeBatch, which must run on a single thread.
+class RegionStore {
+public:
+    // Regions kept open at once, the least recently used one is closed beyond that
+    static constexpr size_t MAX_OPEN_REGIONS = 16;
+
+    explicit RegionStore(std::filesystem::path saveDirectory);
+
+    // Takes a snapshot of the blocks and returns the ticket identifying this save
+    uint64_t queueSave(const std::pair<int, int>& chunkCoord, const ChunkBlocks& blocks);
+
+    // Blocks of the queued save, nullptr once a later save replaced it or it was written
+    std::shared_ptr<const ChunkBlocks> getQueuedSave(const std::pair<int, int>& chunkCoord, uint64_t ticket);
+
+    // Fills in every read's result, grouped by region so each file is read in one pass.
+    // A region that cannot be opened or a payload that cannot be read sets error rather
+    // than looking like a chunk that was never saved.
+    void readBatch(const std::vector<ChunkRead*>& reads);
+
+    // Writes the saves that are still current, one append per region. Failed writes stay
+    // queued, so reads still see their data, and are moved to `failed` for a retry.
+    void writeBatch(std::vector<ChunkWrite>& writes, std::vector<ChunkWrite>& failed);
+
+    // Encodes and writes every save still queued, for shutdown once nothing else touches
+    // the store. Returns how many could not be written.
+    size_t flushQueuedSaves();
+
+    RegionStoreStats getStats();
+
+private:
+    struct QueuedSave {
+        uint64_t ticket;
+        std::shared_ptr<const ChunkBlocks> blocks;
+    };
+
+    struct OpenRegion {
+        std::unique_ptr<RegionFile> file;
+        uint64_t lastUse;
+    };
+
+    // nullptr if the file cannot be opened
+    RegionFile* openRegion(const std::pair<int, int>& regionCoord);
+
+    std::filesystem::path directory;
+
+    // Only used by the thread running readBatch and writeBatch
+    std::map<std::pair<int, int>, OpenRegion> regions;
+    uint64_t useCounter = 0;
+
+    // Guards everything below
+    std::mutex mutex;
+    std::map<std::pair<int, int>, QueuedSave> queuedSaves;
+    uint64_t nextTicket = 1;
+    RegionStoreStats stats;
+};
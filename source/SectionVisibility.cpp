@@ -0,0 +1,72 @@
+#include "SectionVisibility.h"
+#include <bitset>
+
+SectionConnectivity SectionVisibility::compute(const BlockType* blocks, SectionState state) {
+    if (state == SectionState::EMPTY)
+        return ALL_CONNECTED;
+    if (state == SectionState::UNIFORM)
+        return 0;
+
+    constexpr int32_t LAST = CHUNK_SIZE - 1;
+    static_assert(SECTION_HEIGHT == CHUNK_SIZE, "Sections are cubes");
+
+    // Flood fill every air region once and connect all the faces it touches
+    std::bitset<SECTION_VOLUME> visited;
+    std::array<uint16_t, SECTION_VOLUME> stack;
+    SectionConnectivity connectivity = 0;
+
+    for (int32_t start = 0; start < SECTION_VOLUME; ++start) {
+        if (visited[start] || blocks[start] != BlockType::AIR)
+            continue;
+
+        uint8_t faces = 0;
+        size_t top = 0;
+        stack[top++] = static_cast<uint16_t>(start);
+        visited[start] = true;
+
+        while (top > 0) {
+            int32_t index = stack[--top];
+            int32_t x = index % CHUNK_SIZE;
+            int32_t z = (index / CHUNK_SIZE) % CHUNK_SIZE;
+            int32_t y = index / (CHUNK_SIZE * CHUNK_SIZE);
+
+            if (x == 0)    faces |= 1 << static_cast<int>(Face::LEFT);
+            if (x == LAST) faces |= 1 << static_cast<int>(Face::RIGHT);
+            if (y == LAST) faces |= 1 << static_cast<int>(Face::TOP);
+            if (y == 0)    faces |= 1 << static_cast<int>(Face::BOTTOM);
+            if (z == LAST) faces |= 1 << static_cast<int>(Face::FRONT);
+            if (z == 0)    faces |= 1 << static_cast<int>(Face::BACK);
+
+            auto visit = [&](int32_t next) {
+                if (!visited[next] && blocks[next] == BlockType::AIR) {
+                    visited[next] = true;
+                    stack[top++] = static_cast<uint16_t>(next);
+                }
+            };
+            if (x > 0)    visit(index - 1);
+            if (x < LAST) visit(index + 1);
+            if (z > 0)    visit(index - CHUNK_SIZE);
+            if (z < LAST) visit(index + CHUNK_SIZE);
+            if (y > 0)    visit(index - CHUNK_SIZE * CHUNK_SIZE);
+            if (y < LAST) visit(index + CHUNK_SIZE * CHUNK_SIZE);
+        }
+
+        for (int a = 0; a < 6; ++a) {
+            if (!(faces & (1 << a)))
+                continue;
+            for (int b = 0; b < 6; ++b) {
+                if (faces & (1 << b))
+                    connectivity |= 1ull << (a * 6 + b);
+            }
+        }
+    }
+    return connectivity;
+}
+
+ChunkConnectivity SectionVisibility::computeChunk(const std::vector<BlockType>& blocks, const SectionStates& sections) {
+    // Sections are contiguous in y-major order
+    ChunkConnectivity connectivity;
+    for (int32_t s = 0; s < SECTION_COUNT; ++s)
+        connectivity[s] = compute(blocks.data() + s * SECTION_VOLUME, sections[s]);
+    return connectivity;
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include "ChunkStorage.h"
+#include <array>
+#include <cstdint>
+
+// Which faces of a 16-cube section can see each other through air. Bit a * 6 + b is
+// set when some air path inside the section touches both face a and face b, using
+// the Face order. Render-time traversal only leaves a section through a face that is
+// connected to the one it came in through.
+using SectionConnectivity = uint64_t;
+using ChunkConnectivity = std::array<SectionConnectivity, SECTION_COUNT>;
+
+class SectionVisibility {
+public:
+    static constexpr SectionConnectivity ALL_CONNECTED = (1ull << 36) - 1;
+
+    // `blocks` is the section's dense y-major data, unused for empty and uniform sections
+    static SectionConnectivity compute(const BlockType* blocks, SectionState state);
+
+    // All sections of a chunk from its dense data
+    static ChunkConnectivity computeChunk(const std::vector<BlockType>& blocks, const SectionStates& sections);
+
+    static bool isConnected(SectionConnectivity connectivity, Face a, Face b) {
+        return (connectivity >> (static_cast<int>(a) * 6 + static_cast<int>(b))) & 1;
+    }
+};
+
+constexpr Face oppositeFace(Face face) { return static_cast<Face>(static_cast<uint8_t>(face) ^ 1); }
@@ -1,6 +1,8 @@
 #pragma once
 #include <vector>
-#include <queue>
+#include <algorithm>
+#include <deque>
+#include <memory>
 #include <thread>
 #include <mutex>
 #include <condition_variable>
@@ -9,84 +11,150 @@
 #include <atomic>
 #include <exception>
 #include <chrono>
+#include <new>
+#include <cstddef>
+#include <type_traits>
 
+// Type-erased, move-only callable. Callables that fit the inline buffer are stored
+// in place, so enqueueing a typical chunk job does not touch the heap.
+class Task {
+public:
+    static constexpr size_t BUFFER_SIZE = 192;
+
+    Task() = default;
+
+    template<class F, class = std::enable_if_t<!std::is_same_v<std::decay_t<F>, Task>>>
+    Task(F&& f) {
+        using Fn = std::decay_t<F>;
+        if constexpr (fitsInline<Fn>()) {
+            new (buffer) Fn(std::forward<F>(f));
+            ops = &inlineOps<Fn>;
+        }
+        else {
+            new (buffer) Fn*(new Fn(std::forward<F>(f)));
+            ops = &heapOps<Fn>;
+        }
+    }
+
+    Task(Task&& other) noexcept { moveFrom(other); }
+
+    Task& operator=(Task&& other) noexcept {
+        if (this != &other) {
+            reset();
+            moveFrom(other);
+        }
+        return *this;
+    }
+
+    Task(const Task&) = delete;
+    Task& operator=(const Task&) = delete;
+
+    ~Task() { reset(); }
+
+    void operator()() { ops->invoke(buffer); }
+    explicit operator bool() const { return ops != nullptr; }
+
+private:
+    struct Ops {
+        void (*invoke)(void* storage);
+        void (*move)(void* dst, void* src);
+        void (*destroy)(void* storage);
+    };
+
+    template<class Fn>
+    static constexpr bool fitsInline() {
+        return sizeof(Fn) <= BUFFER_SIZE && alignof(Fn) <= alignof(std::max_align_t)
+            && std::is_nothrow_move_constructible_v<Fn>;
+    }
+
+    template<class Fn>
+    static constexpr Ops inlineOps = {
+        [](void* storage) { (*static_cast<Fn*>(storage))(); },
+        [](void* dst, void* src) { new (dst) Fn(std::move(*static_cast<Fn*>(src))); static_cast<Fn*>(src)->~Fn(); },
+        [](void* storage) { static_cast<Fn*>(storage)->~Fn(); }
+    };
+
+    template<class Fn>
+    static constexpr Ops heapOps = {
+        [](void* storage) { (**static_cast<Fn**>(storage))(); },
+        [](void* dst, void* src) { new (dst) Fn*(*static_cast<Fn**>(src)); },
+        [](void* storage) { delete *static_cast<Fn**>(storage); }
+    };
+
+    void moveFrom(Task& other) {
+        ops = other.ops;
+        if (ops) {
+            ops->move(buffer, other.buffer);
+            other.ops = nullptr;
+        }
+    }
+
+    void reset() {
+        if (ops) {
+            ops->destroy(buffer);
+            ops = nullptr;
+        }
+    }
+
+    alignas(std::max_align_t) unsigned char buffer[BUFFER_SIZE];
+    const Ops* ops = nullptr;
+};
+
+// Work-stealing thread pool. Every worker owns a deque: it pushes and pops its own
+// work at the back and, when empty, steals from the front of the other workers' deques.
+// Tasks submitted from outside the pool are spread round-robin over the deques.
 class ThreadPool {
 public:
     // Initializes the thread pool with a specified number of threads and optional delay.
     ThreadPool(size_t threads, std::chrono::milliseconds delay = std::chrono::milliseconds(0))
         : stop(false), delay(delay) {
 
-        // Reserve space for worker threads.
-        workers.reserve(threads);
+        threads = std::max<size_t>(threads, 1);
+
+        // One deque per worker, created before any worker can try to steal from it.
+        queues.reserve(threads);
+        for (size_t i = 0; i < threads; ++i)
+            queues.emplace_back(std::make_unique<WorkerQueue>());
 
         // Create and start the specified number of worker threads.
+        workers.reserve(threads);
         for (size_t i = 0; i < threads; ++i) {
-            workers.emplace_back([this] {
-                while (true) {
-                    std::function<void()> task;  // A task to be executed by the thread.
-
-                    // Acquire lock to safely access the task queue.
-                    {
-                        std::unique_lock<std::mutex> lock(this->queue_mutex);
-
-                        // Wait until there is a task to execute or the pool is stopping.
-                        this->condition.wait(lock, [this] {
-                            return this->stop.load() || !this->tasks.empty();
-                        });
-
-                        // If stop is true and there are no remaining tasks, exit the loop.
-                        if (this->stop.load() && this->tasks.empty())
-                            return;
-
-                        // Get the next task from the queue.
-                        task = std::move(this->tasks.front());
-                        this->tasks.pop();
-                    }
-
-                    // If a delay is specified, the thread sleeps for the given duration before executing the task.
-                    if (this->delay.count() > 0) {
-                        std::this_thread::sleep_for(this->delay);
-                    }
-
-                    // Execute the task.
-                    task();
-                }
-            });
+            workers.emplace_back([this, i] { workerLoop(i); });
         }
     }
 
-    // Enqueue a new task to be executed by the thread pool.
+    // Enqueue a new task and get a future for its result.
     template<class F, class... Args>
     auto enqueue(F&& f, Args&&... args) -> std::future<typename std::invoke_result<F, Args...>::type> {
         using return_type = typename std::invoke_result<F, Args...>::type;
 
-        // Wrap the task into a packaged_task to handle the return value.
-        auto task = std::make_shared<std::packaged_task<return_type()>>(
+        // The packaged_task is moved straight into the task, no std::function or shared_ptr around it.
+        std::packaged_task<return_type()> task(
             std::bind(std::forward<F>(f), std::forward<Args>(args)...)
         );
+        std::future<return_type> res = task.get_future();
 
-        // Retrieve the future from the packaged_task so we can access the result later.
-        std::future<return_type> res = task->get_future();
-
-        {
-            std::lock_guard<std::mutex> lock(queue_mutex);
+        push(Task([task = std::move(task)]() mutable { task(); }));
+        return res;
+    }
 
-            // If the pool is stopping, don't allow new tasks to be enqueued.
-            if (stop.load())
-                throw std::runtime_error("enqueue on stopped ThreadPool");
+    // Enqueue a task whose result nobody waits for. Avoids the future's shared state.
+    template<class F>
+    void submit(F&& f) {
+        push(Task(std::forward<F>(f)));
+    }
 
-            // Add the task to the queue as a lambda function.
-            tasks.emplace([task]() { (*task)(); });
-        }
+    size_t size() const { return workers.size(); }
 
-        // Notify one worker thread that a new task is available.
-        condition.notify_one();
-        return res;
-    }
+    // Number of tasks queued and not yet picked up by a worker.
+    size_t pendingTasks() const { return pending.load(); }
 
     // Waits for all worker threads to finish and cleans up resources.
     ~ThreadPool() {
-        stop.store(true);
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex);
+            stop.store(true);
+        }
         condition.notify_all();
 
         // Join all worker threads (wait for them to finish).
@@ -97,16 +165,110 @@ public:
     }
 
 private:
+    struct WorkerQueue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    void push(Task&& task) {
+        // If the pool is stopping, don't allow new tasks to be enqueued.
+        if (stop.load())
+            throw std::runtime_error("enqueue on stopped ThreadPool");
+
+        // Workers keep their own follow-up work local, everyone else spreads it out.
+        size_t index = (currentPool == this)
+            ? currentIndex
+            : nextQueue.fetch_add(1, std::memory_order_relaxed) % queues.size();
+
+        // Counted before it becomes visible so a worker can never take it first.
+        pending.fetch_add(1);
+        {
+            std::lock_guard<std::mutex> lock(queues[index]->mutex);
+            queues[index]->tasks.push_back(std::move(task));
+        }
+
+        // Only wake someone if a worker is actually asleep. Taking the sleep mutex orders
+        // the notify after that worker's predicate check.
+        if (sleeping.load() > 0) {
+            { std::lock_guard<std::mutex> lock(sleepMutex); }
+            condition.notify_one();
+        }
+    }
+
+    bool popLocal(size_t index, Task& task) {
+        WorkerQueue& queue = *queues[index];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (queue.tasks.empty())
+            return false;
+        task = std::move(queue.tasks.back());
+        queue.tasks.pop_back();
+        return true;
+    }
+
+    bool steal(size_t thief, Task& task) {
+        for (size_t offset = 1; offset < queues.size(); ++offset) {
+            WorkerQueue& queue = *queues[(thief + offset) % queues.size()];
+            std::unique_lock<std::mutex> lock(queue.mutex, std::try_to_lock);
+            if (!lock.owns_lock() || queue.tasks.empty())
+                continue;
+            task = std::move(queue.tasks.front());
+            queue.tasks.pop_front();
+            return true;
+        }
+        return false;
+    }
+
+    void workerLoop(size_t index) {
+        currentPool = this;
+        currentIndex = index;
+
+        while (true) {
+            Task task;  // A task to be executed by the thread.
+
+            if (popLocal(index, task) || steal(index, task)) {
+                pending.fetch_sub(1);
+
+                // If a delay is specified, the thread sleeps for the given duration before executing the task.
+                if (delay.count() > 0) {
+                    std::this_thread::sleep_for(delay);
+                }
+
+                // Execute the task.
+                task();
+                continue;
+            }
+
+            // Nothing to run anywhere: sleep until a task is pushed or the pool is stopping.
+            std::unique_lock<std::mutex> lock(sleepMutex);
+            sleeping.fetch_add(1);
+            condition.wait(lock, [this] {
+                return stop.load() || pending.load() > 0;
+            });
+            sleeping.fetch_sub(1);
+
+            // If stop is true and there are no remaining tasks, exit the loop.
+            if (stop.load() && pending.load() == 0)
+                return;
+        }
+    }
+
     // Vector of worker threads.
     std::vector<std::thread> workers;
 
-    // Queue of tasks to be executed by the workers.
-    std::queue<std::function<void()>> tasks;
+    // One task deque per worker.
+    std::vector<std::unique_ptr<WorkerQueue>> queues;
+
+    // Round-robin cursor for tasks submitted from outside the pool.
+    std::atomic<size_t> nextQueue{ 0 };
 
-    // Mutex to protect access to the task queue.
-    std::mutex queue_mutex;
+    // Tasks pushed but not yet taken by a worker.
+    std::atomic<size_t> pending{ 0 };
 
-    // Condition variable to notify worker threads when new tasks are available.
+    // Workers currently waiting on the condition variable.
+    std::atomic<size_t> sleeping{ 0 };
+
+    // Mutex and condition variable used only to put idle workers to sleep.
+    std::mutex sleepMutex;
     std::condition_variable condition;
 
     // Flag to indicate when the pool is stopping.
@@ -114,4 +276,8 @@ private:
 
     // Delay between task executions.
     std::chrono::milliseconds delay;
+
+    // Pool and deque index of the calling worker thread, if any.
+    inline static thread_local ThreadPool* currentPool = nullptr;
+    inline static thread_local size_t currentIndex = 0;
 };
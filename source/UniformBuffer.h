@@ -0,0 +1,54 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <glm.hpp>
+
+// Per-frame shader data, laid out as the std140 FrameData block in main.vs and main.fs.
+// Only mat4 and vec4 members, so the C++ layout matches std140 without padding.
+struct FrameUniforms {
+    glm::mat4 projection;
+    glm::mat4 view;
+    glm::mat4 model;
+    glm::vec4 cameraPos;
+    glm::vec4 fogColor;
+    glm::vec4 lightPos;
+    glm::vec4 lightColor;
+    glm::vec4 objectColor;
+};
+
+static_assert(sizeof(FrameUniforms) == 3 * 64 + 5 * 16, "FrameUniforms must match the std140 FrameData block");
+
+// Binding point of the FrameData block in the shaders
+constexpr GLuint FRAME_UNIFORMS_BINDING = 0;
+
+// Uniform buffer holding one T, bound to a fixed binding point. The buffer is created
+// on the first update, so instances can exist before the GL context does.
+template<class T>
+class UniformBuffer {
+public:
+    explicit UniformBuffer(GLuint bindingPoint) : binding(bindingPoint) {}
+
+    void update(const T& data) {
+        if (id == 0) {
+            glGenBuffers(1, &id);
+            glBindBuffer(GL_UNIFORM_BUFFER, id);
+            glBufferData(GL_UNIFORM_BUFFER, sizeof(T), nullptr, GL_DYNAMIC_DRAW);
+            glBindBufferBase(GL_UNIFORM_BUFFER, binding, id);
+        }
+
+        glBindBuffer(GL_UNIFORM_BUFFER, id);
+        glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(T), &data);
+        glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    }
+
+    void cleanupOpenGLResources() {
+        if (glIsBuffer(id)) {
+            glDeleteBuffers(1, &id);
+            id = 0;
+        }
+    }
+
+private:
+    GLuint id = 0;
+    GLuint binding;
+};
@@ -3,61 +3,613 @@
 World::World() : threadPool(std::thread::hardware_concurrency()) {
     for (int16_t x = -renderDistance; x <= renderDistance; ++x) {
         for (int16_t z = -renderDistance; z <= renderDistance; ++z) {
-            glm::vec3 position(x * (CHUNK_SIZE - 1), 0, z * (CHUNK_SIZE - 1));
+            glm::vec3 position = chunkPosition(x, z);
             std::pair<int16_t, int16_t> chunkCoord = { x, z };
-            chunks.emplace(chunkCoord, Chunk(position, chunkCoord, this));
+            Chunk& chunk = chunks.emplace(chunkCoord, position, chunkCoord, this);
 
-            threadPool.enqueue([this, chunkCoord, position]() {
-                ChunkMeshData data = generateChunkMeshData(chunkCoord, position);
-                std::lock_guard<std::mutex> lock(meshQueueMutex);
-                meshUploadQueue.push(std::move(data));
-            });
+            enqueueChunkJob(chunk);
         }
     }
 }
 
+World::~World() {
+    // Read completions feed the pool, which shuts down before the I/O queue
+    chunkIO.closeReads();
+
+    // ~ThreadPool runs whatever is still queued before joining, chunk jobs have nothing
+    // left to do by then
+    chunks.forEach([this](Chunk& chunk) {
+        chunk.cancelToken->store(true);
+        cancelledJobCount += scheduler.cancel(chunk.coord);
+        });
+
+    // The pool encodes these before joining and the I/O queue writes them before its
+    // thread exits
+    chunks.forEach([this](Chunk& chunk) {
+        if (chunk.hasUnsavedChanges())
+            saveChunk(chunk);
+        });
+}
+
+void World::cleanupOpenGLResources() {
+    chunkRenderer.cleanupOpenGLResources();
+    meshArena.cleanupOpenGLResources();
+}
+
+void World::saveChunk(Chunk& chunk) {
+    std::pair<int, int> chunkCoord = chunk.coord;
+    if (chunk.isReadOnly()) {
+        std::cerr << "Not saving chunk " << chunkCoord.first << ", " << chunkCoord.second
+            << ", its saved copy could not be read and would be overwritten" << std::endl;
+        chunk.setUnsaved(false);
+        return;
+    }
+
+    uint64_t ticket = regionStore.queueSave(chunkCoord, chunk.getChunkData());
+    chunk.setUnsaved(false);
+
+    // Encoding is CPU work and stays on the pool, the I/O thread only moves bytes
+    threadPool.submit([this, chunkCoord, ticket]() {
+        std::shared_ptr<const ChunkBlocks> blocks = regionStore.getQueuedSave(chunkCoord, ticket);
+        if (!blocks)
+            return;
+
+        ChunkWrite write{ chunkCoord, ticket, {} };
+        encodeChunk(*blocks, write.payload);
+        chunkIO.write(std::move(write));
+        });
+}
+
 void World::processMeshUploads() {
-    std::lock_guard<std::mutex> lock(meshQueueMutex);
-    while (!meshUploadQueue.empty()) {
-        ChunkMeshData mesh = std::move(meshUploadQueue.front());
-        meshUploadQueue.pop();
-
-        Chunk* chunk = getChunkPtr(mesh.coord);
-        if (chunk) {
-            chunk->uploadMeshFromThread(mesh);
+    // Take everything the workers finished in one go, so they are never blocked on the
+    // mutex while this thread talks to the GPU
+    std::vector<ChunkMeshData> finished;
+    {
+        std::lock_guard<std::mutex> lock(meshQueueMutex);
+        finished.swap(meshUploadQueue);
+    }
+    // Edits skip the budget so they show up the frame after their remesh finished
+    for (ChunkMeshData& mesh : finished) {
+        if (mesh.editTime != std::chrono::steady_clock::time_point{})
+            uploadMesh(std::move(mesh));
+        else
+            uploadBacklog.push_back(std::move(mesh));
+    }
+
+    // Whatever is over the byte or time budget is carried over to the next frame.
+    // At least one mesh goes up every frame so a huge one cannot stall the backlog.
+    auto uploadStart = std::chrono::steady_clock::now();
+    size_t uploadedBytes = 0;
+    while (!uploadBacklog.empty()) {
+        if (uploadedBytes > 0 && (uploadedBytes >= streamingSettings.uploadBytesPerFrame
+            || std::chrono::steady_clock::now() - uploadStart >= streamingSettings.uploadTimePerFrame))
+            break;
+
+        ChunkMeshData mesh = std::move(uploadBacklog.front());
+        uploadBacklog.pop_front();
+        uploadedBytes += uploadMesh(std::move(mesh));
+    }
+}
+
+size_t World::uploadMesh(ChunkMeshData&& mesh) {
+    Chunk* chunk = getChunkPtr(mesh.coord);
+    if (!chunk)
+        return 0;
+
+    bool generated = !mesh.blocks.empty();
+    bool loadedFromStore = mesh.loadedFromStore;
+    bool readFailed = mesh.readFailed;
+    uint8_t meshedNeighbourMask = mesh.neighbourMask;
+    size_t bytes = std::max<size_t>(mesh.gpuBytes(), 1);
+    totalMeshingTime += mesh.meshingTime;
+    ++meshedChunkCount;
+    if (mesh.editTime != std::chrono::steady_clock::time_point{})
+        editStats.lastEditLatency = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - mesh.editTime);
+
+    chunk->uploadMeshFromThread(std::move(mesh));
+
+    if (generated) {
+        // Chunks fresh from noise are saved when they leave range, so they are never generated
+        // twice. One whose saved copy could not be read must never replace it.
+        chunk->setUnsaved(!loadedFromStore && !readFailed);
+        chunk->setReadOnly(readFailed);
+        onChunkGenerated(*chunk, meshedNeighbourMask);
+    }
+    return bytes;
+}
+
+void World::onChunkGenerated(Chunk& chunk, uint8_t meshedNeighbourMask) {
+    // Neighbours meshed before this chunk existed still have faces along the shared border
+    for (const auto& offset : NEIGHBOUR_OFFSETS) {
+        Chunk* neighbour = getChunkPtr({ chunk.coord.first + offset[0], chunk.coord.second + offset[1] });
+        if (neighbour && neighbour->hasBlockData())
+            enqueueRemeshJob(*neighbour);
+    }
+
+    // Neighbours edited along the border while this chunk was generating
+    if (chunk.isDirty()) {
+        enqueueRemeshJob(chunk, chunk.getDirtySince());
+        chunk.setDirty(false);
+        ++editStats.remeshedChunks;
+    }
+    // Neighbours that finished while this chunk was generating were not part of its mesh
+    else if (neighbourMask(chunk.coord) != meshedNeighbourMask)
+        enqueueRemeshJob(chunk);
+}
+
+void World::scheduleJob(const std::pair<int, int>& chunkCoord, Task&& job, bool urgent) {
+    ++jobsInFlight;
+    pushJob(chunkCoord, std::move(job), urgent);
+}
+
+void World::pushJob(const std::pair<int, int>& chunkCoord, Task&& job, bool urgent) {
+    scheduler.push(chunkCoord, std::move(job), urgent);
+
+    // Each pool task runs whichever job is most urgent by the time a worker gets to it
+    threadPool.submit([this]() {
+        Task next;
+        if (scheduler.pop(next))
+            next();
+        --jobsInFlight;
+        });
+}
+
+void World::enqueueChunkJob(Chunk& chunk) {
+    std::pair<int16_t, int16_t> chunkCoord = chunk.coord;
+    glm::vec3 position = chunk.getOffset();
+    uint32_t revision = ++meshRevisionCounter;
+
+    // Counted from the moment the read is queued, so streaming never runs ahead of the disk
+    ++jobsInFlight;
+
+    // The read completes on the I/O thread and goes straight into the scheduler, decoding
+    // or generating and meshing run on a worker
+    chunkIO.read(chunkCoord, chunk.cancelToken, [this, chunkCoord, position, revision, cancelToken = chunk.cancelToken, neighbours = gatherNeighbours(chunk.coord)](ChunkReadResult&& stored) mutable {
+        pushJob(chunkCoord, [this, chunkCoord, position, revision, cancelToken, neighbours = std::move(neighbours), stored = std::move(stored)]() {
+            if (cancelToken->load()) {
+                ++cancelledJobCount;
+                return;
+            }
+
+            ChunkMeshData data = generateChunkMeshData(chunkCoord, position, neighbours, cancelToken, stored);
+            if (cancelToken->load()) {
+                ++cancelledJobCount;
+                return;
+            }
+            data.revision = revision;
+
+            std::lock_guard<std::mutex> lock(meshQueueMutex);
+            meshUploadQueue.push_back(std::move(data));
+            });
+        });
+}
+
+void World::enqueueRemeshJob(Chunk& chunk, std::chrono::steady_clock::time_point editTime) {
+    std::pair<int, int> chunkCoord = chunk.coord;
+    glm::vec3 position = chunk.getOffset();
+    uint32_t revision = ++meshRevisionCounter;
+    bool urgent = editTime != std::chrono::steady_clock::time_point{};
+
+    scheduleJob(chunkCoord, [this, chunkCoord, position, revision, editTime, cancelToken = chunk.cancelToken, blocks = chunk.getChunkData(), neighbours = gatherNeighbours(chunk.coord)]() {
+        if (cancelToken->load()) {
+            ++cancelledJobCount;
+            return;
         }
+
+        ChunkMeshData data;
+        data.coord = chunkCoord;
+        data.offset = position;
+        data.revision = revision;
+        data.editTime = editTime;
+
+        std::vector<BlockType> denseBlocks;
+        blocks.unpack(denseBlocks);
+        meshChunkData(data, denseBlocks, blocks.getSectionStates(), neighbours);
+
+        std::lock_guard<std::mutex> lock(meshQueueMutex);
+        meshUploadQueue.push_back(std::move(data));
+        }, urgent);
+}
+
+glm::vec3 World::chunkPosition(int16_t x, int16_t z) {
+    return glm::vec3(x * CHUNK_SIZE, 0, z * CHUNK_SIZE);
+}
+
+ChunkNeighbours World::gatherNeighbours(const std::pair<int, int>& chunkCoord) {
+    ChunkNeighbours neighbours;
+    for (uint8_t i = 0; i < 4; ++i) {
+        Chunk* neighbour = getChunkPtr({ chunkCoord.first + NEIGHBOUR_OFFSETS[i][0], chunkCoord.second + NEIGHBOUR_OFFSETS[i][1] });
+        if (neighbour)
+            neighbours.layers[i] = neighbour->getBorderLayer(oppositeSide(static_cast<NeighbourSide>(i)));
+    }
+    return neighbours;
+}
+
+uint8_t World::neighbourMask(const std::pair<int, int>& chunkCoord) {
+    uint8_t mask = 0;
+    for (uint8_t i = 0; i < 4; ++i) {
+        Chunk* neighbour = getChunkPtr({ chunkCoord.first + NEIGHBOUR_OFFSETS[i][0], chunkCoord.second + NEIGHBOUR_OFFSETS[i][1] });
+        if (neighbour && neighbour->hasBlockData())
+            mask |= 1 << i;
+    }
+    return mask;
+}
+
+void World::setMeshingMode(MeshingMode mode) {
+    if (meshingMode.exchange(mode) == mode)
+        return;
+
+    totalMeshingTime = std::chrono::microseconds(0);
+    meshedChunkCount = 0;
+
+    // Chunks still generating pick up the new mode when their job runs
+    for (Chunk& chunk : getChunks()) {
+        if (chunk.hasBlockData())
+            enqueueRemeshJob(chunk);
     }
 }
 
+MeshStats World::getMeshStats() {
+    MeshStats stats;
+    chunks.forEach([&stats](Chunk& chunk) {
+        stats.faceCount += chunk.getFaceCount();
+        stats.blockDataBytes += chunk.getChunkData().memoryUsage();
+        });
+    stats.gpuBytes = stats.faceCount * sizeof(PackedFace);
+
+    stats.meshedChunks = meshedChunkCount;
+    stats.cancelledJobs = cancelledJobCount.load();
+    if (meshedChunkCount > 0)
+        stats.averageMeshingTimeUs = static_cast<double>(totalMeshingTime.count()) / meshedChunkCount;
+    return stats;
+}
+
+
+void World::render(shader& mainShader, const glm::mat4& projectionView, glm::vec3 cameraPosition) {
+    auto buildStart = std::chrono::steady_clock::now();
 
-void World::render(shader& mainShader) {
-    for (auto& [key, chunk] : chunks) {
-        mainShader.setVec3("chunkOffset", chunk.getOffset());
-        chunk.render(mainShader);
+    renderCandidates.clear();
+    chunks.forEach([this](Chunk& chunk) {
+        if (chunk.isRenderable())
+            renderCandidates.push_back(&chunk);
+        });
+
+    // Only chunks whose occupied box touches the frustum are drawn
+    visibleChunks.clear();
+    if (renderSettings.frustumCulling) {
+        frustumCuller.setFrustum(projectionView);
+        frustumCuller.clear();
+        frustumCuller.reserve(renderCandidates.size());
+        for (const Chunk* chunk : renderCandidates)
+            frustumCuller.addBox(chunk->getBoundsMin(), chunk->getBoundsMax());
+        frustumCuller.cull(visibleChunks);
+    }
+    else {
+        for (uint32_t i = 0; i < renderCandidates.size(); ++i)
+            visibleChunks.push_back(i);
     }
+
+    renderStats.unreachableCount = 0;
+    if (renderSettings.caveCulling)
+        cullUnreachableChunks(cameraPosition);
+
+    renderStats.occludedCount = 0;
+    if (renderSettings.occlusionCulling)
+        cullOccludedChunks(projectionView, cameraPosition);
+
+    drawList.clear();
+    drawList.reserve(visibleChunks.size());
+    for (uint32_t index : visibleChunks) {
+        const Chunk* chunk = renderCandidates[index];
+        drawList.add(meshArena.getSlice(chunk->getMeshHandle()), glm::ivec3(chunk->getOffset()));
+    }
+    renderStats.drawListBuildTime = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - buildStart);
+    renderStats.candidateCount = renderCandidates.size();
+    renderStats.drawCount = drawList.size();
+
+    mainShader.use();
+    meshArena.bind();
+    chunkRenderer.submit(drawList);
+}
+
+void World::cullUnreachableChunks(glm::vec3 cameraPosition) {
+    int32_t cameraSection = static_cast<int32_t>(std::floor(cameraPosition.y / SECTION_HEIGHT));
+    std::pair<int, int> cameraChunk = {
+        static_cast<int>(std::floor(cameraPosition.x / CHUNK_SIZE)),
+        static_cast<int>(std::floor(cameraPosition.z / CHUNK_SIZE)) };
+
+    // Above or below the world, or before the camera's chunk exists, nothing is culled
+    if (cameraSection < 0 || cameraSection >= SECTION_COUNT || !isInRange(cameraChunk) || !hasChunk(cameraChunk))
+        return;
+
+    // One flag per section of the loaded window
+    const int32_t side = 2 * renderDistance + 1;
+    auto sectionIndex = [this, side](int x, int32_t y, int z) {
+        return ((x - centerChunk.first + renderDistance) + side * (z - centerChunk.second + renderDistance)) * SECTION_COUNT + y;
+    };
+    reachedSections.assign(static_cast<size_t>(side) * side * SECTION_COUNT, false);
+
+    // Breadth-first from the camera's section. A section is left only through faces
+    // connected to the one it was entered through, and never in the direction opposite
+    // to one already taken, so the walk keeps heading away from the camera.
+    constexpr uint8_t FROM_CAMERA = 6;
+
+    sectionQueue.clear();
+    sectionQueue.push_back({ cameraChunk.first, cameraChunk.second, cameraSection, FROM_CAMERA, 0 });
+    reachedSections[sectionIndex(cameraChunk.first, cameraSection, cameraChunk.second)] = true;
+
+    for (size_t head = 0; head < sectionQueue.size(); ++head) {
+        SectionStep step = sectionQueue[head];
+        SectionConnectivity connectivity = getChunkPtr({ step.x, step.z })->getSectionConnectivity()[step.y];
+
+        for (uint8_t f = 0; f < 6; ++f) {
+            Face face = static_cast<Face>(f);
+            if (step.directions & (1 << static_cast<uint8_t>(oppositeFace(face))))
+                continue;
+            if (step.entryFace != FROM_CAMERA && !SectionVisibility::isConnected(connectivity, static_cast<Face>(step.entryFace), face))
+                continue;
+
+            int x = step.x + (FACE_AXIS[f] == 0 ? FACE_SIGN[f] : 0);
+            int32_t y = step.y + (FACE_AXIS[f] == 1 ? FACE_SIGN[f] : 0);
+            int z = step.z + (FACE_AXIS[f] == 2 ? FACE_SIGN[f] : 0);
+            if (y < 0 || y >= SECTION_COUNT || !isInRange({ x, z }) || !hasChunk({ x, z }))
+                continue;
+
+            int32_t index = sectionIndex(x, y, z);
+            if (reachedSections[index])
+                continue;
+            reachedSections[index] = true;
+            sectionQueue.push_back({ x, z, y, static_cast<uint8_t>(oppositeFace(face)), static_cast<uint8_t>(step.directions | (1 << f)) });
+        }
+    }
+
+    // Meshes are per chunk, so a chunk is drawn when any of its sections was reached
+    size_t before = visibleChunks.size();
+    visibleChunks.erase(std::remove_if(visibleChunks.begin(), visibleChunks.end(), [&](uint32_t index) {
+        const Chunk* chunk = renderCandidates[index];
+        if (!isInRange(chunk->coord))
+            return false;
+        int32_t first = sectionIndex(chunk->coord.first, 0, chunk->coord.second);
+        return std::none_of(reachedSections.begin() + first, reachedSections.begin() + first + SECTION_COUNT, [](bool reached) { return reached; });
+        }), visibleChunks.end());
+    renderStats.unreachableCount = before - visibleChunks.size();
+}
+
+void World::cullOccludedChunks(const glm::mat4& projectionView, glm::vec3 cameraPosition) {
+    auto distanceTo = [cameraPosition](const Chunk* chunk) {
+        glm::vec3 center = (chunk->getBoundsMin() + chunk->getBoundsMax()) * 0.5f;
+        return glm::dot(center - cameraPosition, center - cameraPosition);
+    };
+
+    // The nearest solid boxes hide the most, everything further out is only tested
+    occluders.clear();
+    for (uint32_t index : visibleChunks) {
+        if (renderCandidates[index]->hasOccluder())
+            occluders.push_back(renderCandidates[index]);
+    }
+    size_t occluderCount = std::min(occluders.size(), renderSettings.maxOccluders);
+    std::partial_sort(occluders.begin(), occluders.begin() + occluderCount, occluders.end(),
+        [&distanceTo](const Chunk* a, const Chunk* b) { return distanceTo(a) < distanceTo(b); });
+
+    occlusionCuller.begin(projectionView);
+    for (size_t i = 0; i < occluderCount; ++i)
+        occlusionCuller.addOccluder(occluders[i]->getOccluderMin(), occluders[i]->getOccluderMax());
+    occlusionCuller.finish();
+
+    size_t before = visibleChunks.size();
+    visibleChunks.erase(std::remove_if(visibleChunks.begin(), visibleChunks.end(), [this](uint32_t index) {
+        const Chunk* chunk = renderCandidates[index];
+        return !occlusionCuller.isVisible(chunk->getBoundsMin(), chunk->getBoundsMax());
+        }), visibleChunks.end());
+    renderStats.occludedCount = before - visibleChunks.size();
 }
 
 std::vector<std::reference_wrapper<Chunk>> World::getChunks()
 {
     std::vector<std::reference_wrapper<Chunk>> chunkList;
-    for (auto& [key, chunk] : chunks) {
+    chunkList.reserve(chunks.size());
+    chunks.forEach([&chunkList](Chunk& chunk) {
         chunkList.push_back(chunk);
-    }
+        });
     return chunkList;
 }
 
+// Rounds towards negative infinity, so block -1 is in chunk -1
+static int floorDiv(int value, int divisor) {
+    return (value >= 0 ? value : value - divisor + 1) / divisor;
+}
+
+BlockType World::getBlock(glm::ivec3 position) {
+    if (position.y < 0 || position.y >= CHUNK_HEIGHT)
+        return BlockType::AIR;
+
+    std::pair<int, int> chunkCoord = { floorDiv(position.x, CHUNK_SIZE), floorDiv(position.z, CHUNK_SIZE) };
+    Chunk* chunk = getChunkPtr(chunkCoord);
+    if (!chunk || !chunk->hasBlockData())
+        return BlockType::AIR;
+
+    return chunk->getBlock(position.x - chunkCoord.first * CHUNK_SIZE, position.y, position.z - chunkCoord.second * CHUNK_SIZE);
+}
+
+bool World::setBlock(glm::ivec3 position, BlockType type) {
+    if (position.y < 0 || position.y >= CHUNK_HEIGHT)
+        return false;
+
+    std::pair<int, int> chunkCoord = { floorDiv(position.x, CHUNK_SIZE), floorDiv(position.z, CHUNK_SIZE) };
+    Chunk* chunk = getChunkPtr(chunkCoord);
+    if (!chunk || !chunk->hasBlockData())
+        return false;
+
+    int32_t x = position.x - chunkCoord.first * CHUNK_SIZE;
+    int32_t z = position.z - chunkCoord.second * CHUNK_SIZE;
+    if (chunk->getBlock(x, position.y, z) == type)
+        return true;
+
+    chunk->setBlock(x, position.y, z, type);
+    chunk->setUnsaved(true);
+    ++editStats.editedBlocks;
+    markDirty(chunkCoord);
+
+    // Neighbours cull their faces against this chunk's border layer
+    if (x == 0)
+        markDirty({ chunkCoord.first - 1, chunkCoord.second });
+    else if (x == CHUNK_SIZE - 1)
+        markDirty({ chunkCoord.first + 1, chunkCoord.second });
+    if (z == 0)
+        markDirty({ chunkCoord.first, chunkCoord.second - 1 });
+    else if (z == CHUNK_SIZE - 1)
+        markDirty({ chunkCoord.first, chunkCoord.second + 1 });
+    return true;
+}
+
+void World::markDirty(const std::pair<int, int>& chunkCoord) {
+    Chunk* chunk = getChunkPtr(chunkCoord);
+    if (!chunk || chunk->isDirty())
+        return;
+
+    // A neighbour still generating may have gathered the border before the edit, it is
+    // remeshed once its blocks arrive, see onChunkGenerated
+    chunk->setDirty(true, std::chrono::steady_clock::now());
+    if (chunk->hasBlockData())
+        dirtyChunks.push_back(chunkCoord);
+}
+
+void World::remeshDirtyChunks() {
+    for (const auto& chunkCoord : dirtyChunks) {
+        // Chunks unloaded since the edit are gone, the slot may hold a clean chunk by now
+        Chunk* chunk = getChunkPtr(chunkCoord);
+        if (!chunk || !chunk->isDirty())
+            continue;
+
+        // Before the snapshot, so the mesher sees sections that were dug out or filled as empty or uniform
+        chunk->compactBlocks();
+        enqueueRemeshJob(*chunk, chunk->getDirtySince());
+        chunk->setDirty(false);
+        ++editStats.remeshedChunks;
+    }
+    dirtyChunks.clear();
+}
+
+std::vector<Chunk*> World::generatedChunksIn(const BlockBox& box) {
+    std::vector<Chunk*> found;
+    for (int x = floorDiv(box.min.x, CHUNK_SIZE); x <= floorDiv(box.max.x, CHUNK_SIZE); ++x) {
+        for (int z = floorDiv(box.min.z, CHUNK_SIZE); z <= floorDiv(box.max.z, CHUNK_SIZE); ++z) {
+            Chunk* chunk = getChunkPtr({ x, z });
+            if (chunk && chunk->hasBlockData())
+                found.push_back(chunk);
+        }
+    }
+    return found;
+}
+
+size_t World::fillBlocks(const BlockBox& box, BlockType type) {
+    BulkEdit edit;
+    edit.type = BulkEditType::FILL;
+    edit.box = box;
+    edit.blockType = type;
+    return applyBulkEdit(edit);
+}
+
+size_t World::replaceBlocks(const BlockBox& box, BlockType from, BlockType to) {
+    BulkEdit edit;
+    edit.type = BulkEditType::REPLACE;
+    edit.box = box;
+    edit.blockType = to;
+    edit.matchType = from;
+    return applyBulkEdit(edit);
+}
+
+size_t World::pasteBlocks(const BlockRegion& region, glm::ivec3 origin) {
+    BulkEdit edit;
+    edit.type = BulkEditType::PASTE;
+    edit.box = { origin, origin + region.size - 1 };
+    edit.region = &region;
+    return applyBulkEdit(edit);
+}
+
+size_t World::applyBulkEdit(const BulkEdit& edit) {
+    auto editStart = std::chrono::steady_clock::now();
+    if (edit.box.empty())
+        return 0;
+
+    // Chunks are only touched by their own task, and this thread waits for all of them
+    // before anything else can look at the blocks
+    std::vector<Chunk*> touched = generatedChunksIn(edit.box);
+    std::vector<std::future<size_t>> results;
+    results.reserve(touched.size());
+    for (Chunk* chunk : touched) {
+        results.push_back(threadPool.enqueue([&edit, chunk]() {
+            std::vector<BlockType> blocks;
+            chunk->getChunkData().unpack(blocks);
+            size_t changed = BulkEditor::apply(edit, blocks, glm::ivec3(chunk->getOffset()));
+            if (changed > 0)
+                chunk->setChunkData(ChunkBlocks(blocks));
+            return changed;
+            }));
+    }
+
+    size_t changedTotal = 0;
+    size_t visited = 0;
+    for (size_t i = 0; i < touched.size(); ++i) {
+        size_t changed = results[i].get();
+        glm::ivec3 origin(touched[i]->getOffset());
+        BlockBox local = BulkEditor::clipToChunk(edit.box, origin);
+        visited += local.volume();
+        if (changed == 0)
+            continue;
+        changedTotal += changed;
+
+        touched[i]->setUnsaved(true);
+
+        // Neighbours cull their faces against the border layers of this chunk
+        std::pair<int, int> coord = touched[i]->coord;
+        markDirty(coord);
+        if (local.min.x == 0)
+            markDirty({ coord.first - 1, coord.second });
+        if (local.max.x == CHUNK_SIZE - 1)
+            markDirty({ coord.first + 1, coord.second });
+        if (local.min.z == 0)
+            markDirty({ coord.first, coord.second - 1 });
+        if (local.max.z == CHUNK_SIZE - 1)
+            markDirty({ coord.first, coord.second + 1 });
+    }
+
+    auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - editStart).count();
+    editStats.editedBlocks += changedTotal;
+    editStats.lastBulkVoxels = visited;
+    editStats.lastBulkVoxelsPerSecond = elapsed > 0.0 ? visited / elapsed : 0.0;
+    return changedTotal;
+}
+
+BlockRegion World::copyBlocks(const BlockBox& box) {
+    BlockRegion region;
+    if (box.empty())
+        return region;
+    region.size = box.size();
+    region.blocks.assign(box.volume(), BlockType::AIR);
+
+    // Every task writes a different part of the region
+    std::vector<Chunk*> touched = generatedChunksIn(box);
+    std::vector<std::future<void>> results;
+    results.reserve(touched.size());
+    for (Chunk* chunk : touched) {
+        results.push_back(threadPool.enqueue([&box, &region, chunk]() {
+            std::vector<BlockType> blocks;
+            chunk->getChunkData().unpack(blocks);
+            BulkEditor::copy(blocks, glm::ivec3(chunk->getOffset()), box, region);
+            }));
+    }
+    for (auto& result : results)
+        result.get();
+    return region;
+}
+
 bool World::hasChunk(const std::pair<int, int>& cpos) {
-    std::lock_guard<std::mutex> lock(chunksMutex);
-    return (chunks.find(cpos) != chunks.end());
+    return chunks.contains(cpos);
 }
 
 Chunk* World::getChunkPtr(const std::pair<int, int>& cpos) {
-    std::lock_guard<std::mutex> lock(chunksMutex);
-    auto it = chunks.find(cpos);
-    if (it != chunks.end()) {
-        return &it->second;
-    }
-    return nullptr;
+    return chunks.find(cpos);
 }
 
 void World::loadChunk(int16_t x, int16_t z) {
@@ -67,132 +619,182 @@ void World::loadChunk(int16_t x, int16_t z) {
         return;
     }
 
-    glm::vec3 position(x * (CHUNK_SIZE - 1), 0, z * (CHUNK_SIZE - 1));
-
-    chunks.emplace(chunkCoord, Chunk(position, chunkCoord, this));
+    glm::vec3 position = chunkPosition(x, z);
 
-    threadPool.enqueue([this, chunkCoord, position]() {
-        ChunkMeshData data = generateChunkMeshData(chunkCoord, position);
+    Chunk& chunk = chunks.emplace(chunkCoord, position, chunkCoord, this);
 
-        std::lock_guard<std::mutex> lock(meshQueueMutex);
-        meshUploadQueue.push(std::move(data));
-        });
+    enqueueChunkJob(chunk);
 }
 
 void World::unloadChunk(int16_t x, int16_t z) {
     std::pair<int16_t, int16_t> chunkCoord = { x, z };
 
-    auto it = chunks.find(chunkCoord);
-    if (it != chunks.end()) {
-        it->second.cleanupOpenGLResources();
-        chunks.erase(it);
+    Chunk* chunk = chunks.find(chunkCoord);
+    if (chunk) {
+        // Queued jobs are dropped outright, running ones see the token
+        chunk->cancelToken->store(true);
+        cancelledJobCount += scheduler.cancel(chunkCoord);
+
+        if (chunk->hasUnsavedChanges())
+            saveChunk(*chunk);
+
+        chunk->cleanupOpenGLResources();
+        chunks.erase(chunkCoord);
     }
 }
 
-void World::updateChunks(glm::vec3 playerPosition) {
+// Calls fn for every chunk inside the square window around `center` that is not inside the
+// one around `previous`. Both windows have the same size, so the difference is at most one
+// band of columns plus one band of rows and the cost grows with the perimeter, not the area.
+template<class F>
+static void forEachChunkEntering(std::pair<int, int> center, std::pair<int, int> previous, int radius, F&& fn) {
+    const int oldMinX = previous.first - radius, oldMaxX = previous.first + radius;
+    const int oldMinZ = previous.second - radius, oldMaxZ = previous.second + radius;
+
+    for (int x = center.first - radius; x <= center.first + radius; ++x) {
+        const int minZ = center.second - radius, maxZ = center.second + radius;
+        if (x < oldMinX || x > oldMaxX) {
+            for (int z = minZ; z <= maxZ; ++z)
+                fn(x, z);
+            continue;
+        }
+        for (int z = minZ; z <= std::min(maxZ, oldMinZ - 1); ++z)
+            fn(x, z);
+        for (int z = std::max(minZ, oldMaxZ + 1); z <= maxZ; ++z)
+            fn(x, z);
+    }
+}
+
+void World::updateChunks(glm::vec3 playerPosition, glm::vec3 lookDirection) {
     int16_t playerChunkX = static_cast<int16_t>(std::floor(playerPosition.x / CHUNK_SIZE));
     int16_t playerChunkZ = static_cast<int16_t>(std::floor(playerPosition.z / CHUNK_SIZE));
 
-    std::unordered_set<std::pair<int16_t, int16_t>, hash_pair> activeChunks;
+    // Re-prioritise queued work when the player changes chunk or turns noticeably
+    constexpr GLfloat refocusAngleCos = 0.95f;
+    std::pair<int, int> playerChunk = { playerChunkX, playerChunkZ };
+    if (playerChunk != focusChunk || glm::dot(lookDirection, focusDirection) < refocusAngleCos) {
+        scheduler.setFocus(playerPosition, lookDirection);
+        focusChunk = playerChunk;
+        focusDirection = lookDirection;
+    }
 
-    for (int16_t x = -renderDistance; x <= renderDistance; ++x) {
-        for (int16_t z = -renderDistance; z <= renderDistance; ++z) {
-            std::pair<int16_t, int16_t> chunkCoord = { playerChunkX + x, playerChunkZ + z };
-            activeChunks.insert(chunkCoord);
+    // Only the rows and columns that enter or leave range are touched, and only when the
+    // player crosses a chunk border
+    if (playerChunk != centerChunk) {
+        std::pair<int, int> previousCenter = centerChunk;
+        centerChunk = playerChunk;
 
-            if (!hasChunk(chunkCoord)) {
-                std::lock_guard<std::mutex> lock(pendingMutex);
-                if (std::find(pendingChunks.begin(), pendingChunks.end(), chunkCoord) == pendingChunks.end()) {
-                    pendingChunks.push_back(chunkCoord);
-                }
-            }
-        }
-    }
+        forEachChunkEntering(previousCenter, centerChunk, renderDistance, [this](int x, int z) {
+            unloadChunk(static_cast<int16_t>(x), static_cast<int16_t>(z));
+        });
 
-    auto now = std::chrono::steady_clock::now();
-    if (now - lastChunkLoadTime >= loadDelay) {
         std::lock_guard<std::mutex> lock(pendingMutex);
-        if (!pendingChunks.empty()) {
-            auto coord = pendingChunks.front();
-            pendingChunks.pop_front();
-            loadChunk(coord.first, coord.second);
-            lastChunkLoadTime = now;
-        }
-    }
 
-    std::vector<std::pair<int16_t, int16_t>> chunksToUnload;
-    {
-        std::lock_guard<std::mutex> lock(chunksMutex);
-        for (const auto& [chunkCoord, chunk] : chunks) {
-            if (activeChunks.find(chunkCoord) == activeChunks.end()) {
-                chunksToUnload.push_back(chunkCoord);
-            }
-        }
+        // Never start chunks that left render distance before their turn came
+        pendingChunks.erase(std::remove_if(pendingChunks.begin(), pendingChunks.end(),
+            [this](const std::pair<int, int>& coord) { return !isInRange(coord); }), pendingChunks.end());
+
+        forEachChunkEntering(centerChunk, previousCenter, renderDistance, [this](int x, int z) {
+            pendingChunks.emplace_back(x, z);
+        });
     }
 
-    for (const auto& chunkCoord : chunksToUnload) {
-        unloadChunk(chunkCoord.first, chunkCoord.second);
+    // Keep every worker busy but no more than that, so the rest of the window is still
+    // picked by priority when a worker frees up rather than sitting in the queue
+    size_t jobLimit = threadPool.size() * static_cast<size_t>(std::max(streamingSettings.jobsPerWorker, 1));
+
+    std::lock_guard<std::mutex> lock(pendingMutex);
+    while (!pendingChunks.empty() && jobsInFlight.load() < jobLimit) {
+        auto best = std::min_element(pendingChunks.begin(), pendingChunks.end(),
+            [this](const std::pair<int, int>& a, const std::pair<int, int>& b) {
+                return scheduler.priority(a) < scheduler.priority(b);
+            });
+        auto coord = *best;
+        pendingChunks.erase(best);
+        loadChunk(coord.first, coord.second);
     }
 }
 
-ChunkMeshData World::generateChunkMeshData(std::pair<int16_t, int16_t> chunkCoord, glm::vec3 position) {
+size_t World::getPendingChunkCount() {
+    std::lock_guard<std::mutex> lock(pendingMutex);
+    return pendingChunks.size();
+}
+
+bool World::isInRange(const std::pair<int, int>& chunkCoord) const {
+    return std::abs(chunkCoord.first - centerChunk.first) <= renderDistance
+        && std::abs(chunkCoord.second - centerChunk.second) <= renderDistance;
+}
+
+ChunkMeshData World::generateChunkMeshData(std::pair<int16_t, int16_t> chunkCoord, glm::vec3 position, const ChunkNeighbours& neighbours, const CancelToken& cancelToken, const ChunkReadResult& stored) {
     ChunkMeshData data;
     data.coord = chunkCoord;
     data.offset = position;
-    data.blocks.resize(CHUNK_SIZE * CHUNK_HEIGHT * CHUNK_SIZE, BlockType::AIR);
-
-    FastNoiseLite noise;
-    noise.SetNoiseType(FastNoiseLite::NoiseType_Perlin);
-    noise.SetFractalOctaves(1);
-    noise.SetFractalLacunarity(1.0f);
-    noise.SetFractalGain(0.5f);
-    constexpr GLfloat noiseScale = 0.9f;
-
-    // Generate block data
-    for (int16_t x = 0; x < CHUNK_SIZE; ++x) {
-        for (int16_t z = 0; z < CHUNK_SIZE; ++z) {
-            GLfloat worldX = position.x + x;
-            GLfloat worldZ = position.z + z;
-            GLfloat noiseValue = noise.GetNoise(worldX * noiseScale, worldZ * noiseScale);
-            int16_t height = static_cast<int16_t>((noiseValue + 1.0f) * 0.5f * CHUNK_HEIGHT);
-            for (int16_t y = 0; y <= height; ++y) {
-                data.blocks[x + CHUNK_SIZE * (y + CHUNK_HEIGHT * z)] = BlockType::SOLID;
-            }
+    std::vector<BlockType> blocks;
+
+    // Saved chunks, edited or not, are never generated again. Payloads that cannot be read
+    // or decoded are, but read-only, so they are never saved over what is on disk.
+    if (stored.error) {
+        data.readFailed = true;
+        std::cerr << "Failed to read chunk " << chunkCoord.first << ", " << chunkCoord.second << " from its region file, generating it read-only" << std::endl;
+    }
+    else if (stored.queuedBlocks) {
+        data.blocks = *stored.queuedBlocks;
+        data.loadedFromStore = true;
+    }
+    else if (!stored.payload.empty()) {
+        data.loadedFromStore = decodeChunk(stored.payload.data(), stored.payload.size(), data.blocks);
+        if (!data.loadedFromStore) {
+            data.readFailed = true;
+            std::cerr << "Chunk " << chunkCoord.first << ", " << chunkCoord.second
+                << " in region file is corrupt or uses unknown block types, generating it read-only" << std::endl;
         }
     }
 
-    // Generate mesh
-    GLuint indexOffset = 0;
-    for (int16_t x = 0; x < CHUNK_SIZE; ++x) {
-        for (int16_t y = 0; y < CHUNK_HEIGHT; ++y) {
+    if (data.loadedFromStore) {
+        data.blocks.unpack(blocks);
+    }
+    else {
+        blocks.assign(CHUNK_VOLUME, BlockType::AIR);
+
+        FastNoiseLite noise;
+        noise.SetNoiseType(FastNoiseLite::NoiseType_Perlin);
+        noise.SetFractalOctaves(1);
+        noise.SetFractalLacunarity(1.0f);
+        noise.SetFractalGain(0.5f);
+        constexpr GLfloat noiseScale = 0.9f;
+
+        // Generate block data
+        for (int16_t x = 0; x < CHUNK_SIZE; ++x) {
             for (int16_t z = 0; z < CHUNK_SIZE; ++z) {
-                int16_t idx = x + CHUNK_SIZE * (y + CHUNK_HEIGHT * z);
-                if (data.blocks[idx] == BlockType::AIR) continue;
-
-                glm::vec3 blockPos(x, y, z);
-
-                // A helper that only works for blocks inside the same chunk
-                auto isFaceVisibleInternal = [&](int16_t nx, int16_t ny, int16_t nz) -> bool {
-                    if (nx < 0 || ny < 0 || nz < 0 || nx >= CHUNK_SIZE || ny >= CHUNK_HEIGHT || nz >= CHUNK_SIZE)
-                        return true;
-                    return data.blocks[nx + CHUNK_SIZE * (ny + CHUNK_HEIGHT * nz)] == BlockType::AIR;
-                };
-
-                if (isFaceVisibleInternal(x - 1, y, z))
-                    AddFaceToMesh(data.vertices, data.indices, blockPos, LEFT_FACE, indexOffset);
-                if (isFaceVisibleInternal(x + 1, y, z))
-                    AddFaceToMesh(data.vertices, data.indices, blockPos, RIGHT_FACE, indexOffset);
-                if (isFaceVisibleInternal(x, y + 1, z))
-                    AddFaceToMesh(data.vertices, data.indices, blockPos, TOP_FACE, indexOffset);
-                if (isFaceVisibleInternal(x, y - 1, z))
-                    AddFaceToMesh(data.vertices, data.indices, blockPos, BOTTOM_FACE, indexOffset);
-                if (isFaceVisibleInternal(x, y, z + 1))
-                    AddFaceToMesh(data.vertices, data.indices, blockPos, FRONT_FACE, indexOffset);
-                if (isFaceVisibleInternal(x, y, z - 1))
-                    AddFaceToMesh(data.vertices, data.indices, blockPos, BACK_FACE, indexOffset);
+                GLfloat worldX = position.x + x;
+                GLfloat worldZ = position.z + z;
+                GLfloat noiseValue = noise.GetNoise(worldX * noiseScale, worldZ * noiseScale);
+                int16_t height = std::min(static_cast<int16_t>((noiseValue + 1.0f) * 0.5f * CHUNK_HEIGHT), static_cast<int16_t>(CHUNK_HEIGHT - 1));
+                for (int16_t y = 0; y <= height; ++y) {
+                    blocks[blockIndex(x, y, z)] = BlockType::SOLID;
+                }
             }
         }
+
+        // The chunk may have left render distance while its terrain was generated
+        if (cancelToken->load())
+            return data;
+
+        data.blocks = ChunkBlocks(blocks);
     }
 
+    // Generate mesh
+    meshChunkData(data, blocks, data.blocks.getSectionStates(), neighbours);
+
     return data;
+}
+
+void World::meshChunkData(ChunkMeshData& data, const std::vector<BlockType>& blocks, const SectionStates& sections, const ChunkNeighbours& neighbours) {
+    auto meshingStart = std::chrono::steady_clock::now();
+    Mesher::build(meshingMode.load(), blocks, sections, neighbours, data.faces);
+    data.meshingTime = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - meshingStart);
+    data.neighbourMask = neighbours.presentMask();
+    std::tie(data.minHeight, data.maxHeight) = occupiedHeightRange(blocks, sections);
+    std::tie(data.solidMinHeight, data.solidMaxHeight) = solidHeightRange(blocks, sections);
+    data.sectionConnectivity = SectionVisibility::computeChunk(blocks, sections);
 }
\ No newline at end of file
@@ -1,22 +1,64 @@
 #pragma once
 
-#include <unordered_map>
-#include <queue>
-#include <map>
-#include <unordered_set>
+#include <deque>
 #include "Chunk.h"
+#include "BulkEdit.h"
+#include "ChunkGrid.h"
+#include "ChunkRenderer.h"
+#include "FrustumCuller.h"
+#include "OcclusionCuller.h"
+#include "Mesher.h"
 #include "ThreadPool.h"
+#include "ChunkScheduler.h"
+#include "ChunkIO.h"
 
-struct hash_pair {
-    size_t operator()(const std::pair<int, int>& p) const {
-        return std::hash<int>()(p.first) ^ (std::hash<int>()(p.second) << 1);
-    }
+struct MeshStats {
+    size_t faceCount = 0;
+    size_t gpuBytes = 0;
+    size_t blockDataBytes = 0;
+    size_t meshedChunks = 0;
+    size_t cancelledJobs = 0;
+    double averageMeshingTimeUs = 0.0;
+};
+
+struct RenderSettings {
+    bool frustumCulling = true;
+    bool caveCulling = false;
+    bool occlusionCulling = false;
+    size_t maxOccluders = 32;                           // Nearest solid chunk boxes rasterised per frame
+};
+
+struct RenderStats {
+    size_t candidateCount = 0;                          // Chunks with a mesh
+    size_t unreachableCount = 0;                        // Chunks no air path from the camera leads to
+    size_t occludedCount = 0;                           // Chunks hidden by the occlusion pass
+    size_t drawCount = 0;                               // Chunks left after culling
+    std::chrono::microseconds drawListBuildTime{ 0 };   // Culling included
+};
+
+struct EditStats {
+    size_t editedBlocks = 0;
+    size_t remeshedChunks = 0;                          // Remeshes scheduled for edits
+    std::chrono::microseconds lastEditLatency{ 0 };     // Oldest edit to its mesh being uploaded
+    size_t lastBulkVoxels = 0;                          // Blocks visited by the last bulk edit
+    double lastBulkVoxelsPerSecond = 0.0;
+};
+
+// Runtime limits on how fast chunks stream in
+struct StreamingSettings {
+    int jobsPerWorker = 1;                              // Chunk jobs kept in flight per pool worker
+    size_t uploadBytesPerFrame = 4 * 1024 * 1024;       // Mesh data sent to the GPU per frame
+    std::chrono::microseconds uploadTimePerFrame{ 2000 }; // Time spent uploading meshes per frame
 };
 
 class World {
 public:
     World();
-    void render(shader& mainShader);
+    // Saves every chunk with unsaved changes before the pool shuts down
+    ~World();
+    // Deletes the shared GL buffers, must run while the context is still current
+    void cleanupOpenGLResources();
+    void render(shader& mainShader, const glm::mat4& projectionView, glm::vec3 cameraPosition);
     std::vector<std::reference_wrapper<Chunk>> getChunks();
 
     bool hasChunk(const std::pair<int, int>& cpos);
@@ -25,20 +67,125 @@ public:
 
     void loadChunk(int16_t x, int16_t z);
     void unloadChunk(int16_t x, int16_t z);
-    void updateChunks(glm::vec3 playerPosition);
+    void updateChunks(glm::vec3 playerPosition, glm::vec3 lookDirection);
 
     void processMeshUploads();  
+
+    // World block coordinates. Blocks of chunks that are not loaded or not generated yet
+    // read as air and cannot be set, setBlock returns false for those.
+    BlockType getBlock(glm::ivec3 position);
+    bool setBlock(glm::ivec3 position, BlockType type);
+
+    // Schedules one remesh for every chunk edited since the last call. Called once per
+    // frame, so any number of edits to a chunk within a frame cost a single remesh.
+    void remeshDirtyChunks();
+
+    // Box edits over many chunks. Every touched chunk is edited as one task on the
+    // thread pool and gets a single remesh with the next remeshDirtyChunks, however many
+    // of its blocks changed. Chunks not generated yet are skipped. Return blocks changed.
+    size_t fillBlocks(const BlockBox& box, BlockType type);
+    size_t replaceBlocks(const BlockBox& box, BlockType from, BlockType to);
+    size_t pasteBlocks(const BlockRegion& region, glm::ivec3 origin);
+    // Blocks outside generated chunks are copied as air
+    BlockRegion copyBlocks(const BlockBox& box);
+    const EditStats& getEditStats() const { return editStats; }
+
+    // Switching modes remeshes every loaded chunk so the results can be compared
+    void setMeshingMode(MeshingMode mode);
+    MeshingMode getMeshingMode() const { return meshingMode.load(); }
+    MeshStats getMeshStats();
+
+    StreamingSettings& getStreamingSettings() { return streamingSettings; }
+    size_t getJobsInFlight() const { return jobsInFlight.load(); }
+    size_t getPendingChunkCount();
+    size_t getUploadBacklogSize() const { return uploadBacklog.size(); }
+
+    RegionStoreStats getRegionStoreStats() { return regionStore.getStats(); }
+    ChunkIOStats getChunkIOStats() { return chunkIO.getStats(); }
+
+    MeshArena& getMeshArena() { return meshArena; }
+    const RenderStats& getRenderStats() const { return renderStats; }
+    RenderSettings& getRenderSettings() { return renderSettings; }
 private:
     constexpr static int16_t renderDistance = 10;
-    std::unordered_map<std::pair<int, int>, Chunk, hash_pair> chunks;
-    ThreadPool threadPool;
+    // Shared buffers every chunk mesh lives in, grown on demand
+    MeshArena meshArena{ 1u << 20 };
+    // Rebuilt every frame and drawn with a single multi-draw
+    DrawCommandList drawList;
+    ChunkRenderer chunkRenderer;
+    RenderStats renderStats;
+    RenderSettings renderSettings;
+    FrustumCuller frustumCuller;
+    std::vector<Chunk*> renderCandidates;
+    std::vector<uint32_t> visibleChunks;                // Indices into renderCandidates
+    OcclusionCuller occlusionCuller;
+    std::vector<Chunk*> occluders;
+    void cullOccludedChunks(const glm::mat4& projectionView, glm::vec3 cameraPosition);
+
+    // Section visibility graph traversal, see cullUnreachableChunks
+    struct SectionStep {
+        int x, z;
+        int32_t y;
+        uint8_t entryFace;      // 6 for the camera's own section
+        uint8_t directions;     // Faces stepped through so far, as a bitmask
+    };
+    std::vector<SectionStep> sectionQueue;
+    std::vector<bool> reachedSections;
+    void cullUnreachableChunks(glm::vec3 cameraPosition);
+
+    // Only touched from the main thread, workers get snapshots of what they need
+    ChunkGrid chunks{ renderDistance };
+    // Chunks are saved when they leave range and read back before any generation, all
+    // disk access goes through chunkIO's thread
+    RegionStore regionStore{ "saves/world" };
+    ChunkIOQueue chunkIO{ regionStore };
+    void saveChunk(Chunk& chunk);
+    ChunkScheduler scheduler;   // Declared before threadPool so workers never outlive it, as is everything above
+    // Touched by jobs, which can still be running while ~ThreadPool drains its queue
     std::mutex meshQueueMutex;
-    std::mutex chunksMutex;
-    std::queue<ChunkMeshData> meshUploadQueue;
-    ChunkMeshData generateChunkMeshData(std::pair<int16_t, int16_t> chunkCoord, glm::vec3 position);
+    std::vector<ChunkMeshData> meshUploadQueue;         // Filled by workers under meshQueueMutex
+    std::atomic<MeshingMode> meshingMode{ MeshingMode::BINARY };
+    std::atomic<size_t> cancelledJobCount{ 0 };
+    // Jobs scheduled and not finished yet, queued or running
+    std::atomic<size_t> jobsInFlight{ 0 };
+    ThreadPool threadPool;
+    std::deque<ChunkMeshData> uploadBacklog;            // Main thread only, carried over between frames
+    ChunkMeshData generateChunkMeshData(std::pair<int16_t, int16_t> chunkCoord, glm::vec3 position, const ChunkNeighbours& neighbours, const CancelToken& cancelToken, const ChunkReadResult& stored);
+    void meshChunkData(ChunkMeshData& data, const std::vector<BlockType>& blocks, const SectionStates& sections, const ChunkNeighbours& neighbours);
+    void scheduleJob(const std::pair<int, int>& chunkCoord, Task&& job, bool urgent = false);
+    // Same without counting the job, for work that was counted when it started elsewhere.
+    // Safe to call from any thread.
+    void pushJob(const std::pair<int, int>& chunkCoord, Task&& job, bool urgent = false);
+    void enqueueChunkJob(Chunk& chunk);
+    // Remeshes for edits pass the time of the oldest edit, they jump the queue and the upload budget
+    void enqueueRemeshJob(Chunk& chunk, std::chrono::steady_clock::time_point editTime = {});
+    size_t uploadMesh(ChunkMeshData&& mesh);
+    void onChunkGenerated(Chunk& chunk, uint8_t meshedNeighbourMask);
+
+    static glm::vec3 chunkPosition(int16_t x, int16_t z);
+    ChunkNeighbours gatherNeighbours(const std::pair<int, int>& chunkCoord);
+    uint8_t neighbourMask(const std::pair<int, int>& chunkCoord);
+
+    // Every mesh job gets a new revision so results that finish out of order are dropped
+    uint32_t meshRevisionCounter = 0;
+    std::chrono::microseconds totalMeshingTime{ 0 };
+    size_t meshedChunkCount = 0;
     std::deque<std::pair<int, int>> pendingChunks;
     std::mutex pendingMutex;
 
-    std::chrono::steady_clock::time_point lastChunkLoadTime;
-    std::chrono::milliseconds loadDelay = std::chrono::milliseconds(10);
+    // Chunk the loaded window is centred on
+    std::pair<int, int> centerChunk{ 0, 0 };
+    bool isInRange(const std::pair<int, int>& chunkCoord) const;
+
+    std::pair<int, int> focusChunk{ INT32_MAX, INT32_MAX };
+    glm::vec3 focusDirection{ 0.0f };
+
+    // Chunks with block edits that have not been remeshed yet
+    std::vector<std::pair<int, int>> dirtyChunks;
+    void markDirty(const std::pair<int, int>& chunkCoord);
+    size_t applyBulkEdit(const BulkEdit& edit);
+    std::vector<Chunk*> generatedChunksIn(const BlockBox& box);
+    EditStats editStats;
+
+    StreamingSettings streamingSettings;
 };
\ No newline at end of file
@@ -12,6 +12,7 @@ GLfloat deltaTime = 0.0f;
 GLfloat lastFrame = 0.0f;
 
 Camera camera;
+UniformBuffer<FrameUniforms> frameUniforms(FRAME_UNIFORMS_BINDING);
 
 GLdouble lastTime = glfwGetTime();
 uint8_t nbFrames = 0;
@@ -34,7 +35,7 @@ int main()
 	glfwSetCursorPosCallback(window, main::mouse_callback);
 	glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
 
-	shader mainShader("main.vs", "main.fs");
+	shader mainShader("main.vs", "main.fs", faceTablesGLSL());
 
 	glfwSetScrollCallback(window, main::scroll_callback);
 	glfwSetMouseButtonCallback(window, main::mouseButtonCallback);
@@ -61,7 +62,7 @@ int main()
 
 	// Cleanup
 	main::cleanupImGui();
-	main::cleanup(mainShader);
+	main::cleanup(mainShader, world);
 
 	glfwTerminate();
 	return 0;
@@ -78,34 +79,38 @@ void main::processRendering(GLFWwindow* window, shader& mainShader, World& world
 	glClearColor(0.4f, 0.6f, 0.8f, 1.0f);
 	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-	// Set Shader Uniforms
-	mainShader.use();
-	mainShader.setMat4("model", model);
-	mainShader.setMat4("view", view);
-	mainShader.setMat4("projection", projection);
+	// Per-frame shader data goes up in one uniform buffer update
+	FrameUniforms frame;
+	frame.model = model;
+	frame.view = view;
+	frame.projection = projection;
+
+	frame.objectColor = glm::vec4(1.0f, 0.5f, 0.31f, 1.0f);
+	frame.lightColor = glm::vec4(1.0f, 1.0f, 1.0f, 1.0f);
+	frame.lightPos = glm::vec4(5.0f, 100.0f, 5.0f, 1.0f);
 
-	mainShader.setVec3("objectColor", glm::vec3(1.0f, 0.5f, 0.31f));
-	mainShader.setVec3("lightColor", glm::vec3(1.0f, 1.0f, 1.0f));
-	mainShader.setVec3("lightPos", glm::vec3(5.0f, 100.0f, 5.0f));
+	frame.cameraPos = glm::vec4(camera.getPosition(), 1.0f);
+	frame.fogColor = glm::vec4(0.4f, 0.6f, 0.8f, 1.0f);
+	frameUniforms.update(frame);
 
-	mainShader.setVec3("cameraPos", camera.getPosition());
-	mainShader.setVec3("fogColor", glm::vec3(0.4f, 0.6f, 0.8f));
+	mainShader.use();
 
 	std::cout << "Player position: "
 		<< camera.getPosition().x << ", "
 		<< camera.getPosition().y << ", "
 		<< camera.getPosition().z << std::endl;
 
+	world.remeshDirtyChunks();
 	world.processMeshUploads();
-	world.updateChunks(camera.getPosition());
-	world.render(mainShader);
+	world.updateChunks(camera.getPosition(), camera.getLookDirection());
+	world.render(mainShader, projection * view, camera.getPosition());
 
 	ImGui_ImplOpenGL3_NewFrame();
 	ImGui_ImplGlfw_NewFrame();
 	ImGui::NewFrame();
 
 	// ImGui
-	if (isGUIEnabled) main::renderImGui(window);
+	if (isGUIEnabled) main::renderImGui(window, world);
 
 	ImGui::Render();
 	ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
@@ -176,7 +181,7 @@ void main::initializeImGui(GLFWwindow* window)
 	ImGui::StyleColorsDark();
 }
 
-void main::renderImGui(GLFWwindow* window)
+void main::renderImGui(GLFWwindow* window, World& world)
 {
 	glDisable(GL_DEPTH_TEST);
 
@@ -203,6 +208,107 @@ void main::renderImGui(GLFWwindow* window)
 		ImGui::Text("Current Memory Usage: %zu MB", memoryUsage);
 	}
 
+	//// Chunk Meshing ////
+	ImGui::Separator();
+	if (ImGui::CollapsingHeader("Chunk Meshing", ImGuiTreeNodeFlags_DefaultOpen)) {
+		const char* meshingModes[] = { "Naive", "Greedy", "Binary" };
+		int currentMode = static_cast<int>(world.getMeshingMode());
+		if (ImGui::Combo("Mode", &currentMode, meshingModes, IM_ARRAYSIZE(meshingModes)))
+			world.setMeshingMode(static_cast<MeshingMode>(currentMode));
+
+		MeshStats stats = world.getMeshStats();
+		ImGui::Text("Faces: %zu", stats.faceCount);
+		ImGui::Text("Mesh Memory: %.2f MB", stats.gpuBytes / (1024.0 * 1024.0));
+		ImGui::Text("Block Data Memory: %.2f MB", stats.blockDataBytes / (1024.0 * 1024.0));
+		ImGui::Text("Avg Meshing Time: %.1f us (%zu chunks)", stats.averageMeshingTimeUs, stats.meshedChunks);
+		ImGui::Text("Cancelled Jobs: %zu", stats.cancelledJobs);
+	}
+
+	//// World Editing ////
+	ImGui::Separator();
+	if (ImGui::CollapsingHeader("World Editing")) {
+		static int editRadius = 16;
+		ImGui::SliderInt("Radius", &editRadius, 1, 64);
+
+		// Box around the camera, for trying out bulk edits
+		glm::ivec3 center(glm::floor(camera.getPosition()));
+		BlockBox box{ center - editRadius, center + editRadius };
+		if (ImGui::Button("Clear Box"))
+			world.fillBlocks(box, BlockType::AIR);
+		ImGui::SameLine();
+		if (ImGui::Button("Fill Box Below")) {
+			BlockBox below{ box.min - glm::ivec3(0, 2 * editRadius + 2, 0), box.max - glm::ivec3(0, 2 * editRadius + 2, 0) };
+			world.fillBlocks(below, BlockType::SOLID);
+		}
+
+		const EditStats& editStats = world.getEditStats();
+		ImGui::Text("Block Edits: %zu (%zu remeshes)", editStats.editedBlocks, editStats.remeshedChunks);
+		ImGui::Text("Edit To Mesh: %.2f ms", editStats.lastEditLatency.count() / 1000.0);
+		ImGui::Text("Last Bulk Edit: %zu voxels, %.1f M voxels/s", editStats.lastBulkVoxels, editStats.lastBulkVoxelsPerSecond / 1e6);
+	}
+
+	//// Chunk Streaming ////
+	ImGui::Separator();
+	if (ImGui::CollapsingHeader("Chunk Streaming", ImGuiTreeNodeFlags_DefaultOpen)) {
+		StreamingSettings& settings = world.getStreamingSettings();
+		ImGui::SliderInt("Jobs Per Worker", &settings.jobsPerWorker, 1, 8);
+
+		int uploadBudgetKB = static_cast<int>(settings.uploadBytesPerFrame / 1024);
+		if (ImGui::SliderInt("Upload Budget (KB/frame)", &uploadBudgetKB, 64, 16384))
+			settings.uploadBytesPerFrame = static_cast<size_t>(uploadBudgetKB) * 1024;
+
+		int uploadBudgetUs = static_cast<int>(settings.uploadTimePerFrame.count());
+		if (ImGui::SliderInt("Upload Budget (us/frame)", &uploadBudgetUs, 100, 16000))
+			settings.uploadTimePerFrame = std::chrono::microseconds(uploadBudgetUs);
+
+		ImGui::Text("Jobs In Flight: %zu", world.getJobsInFlight());
+		ImGui::Text("Pending Chunks: %zu", world.getPendingChunkCount());
+		ImGui::Text("Upload Backlog: %zu", world.getUploadBacklogSize());
+
+		RegionStoreStats store = world.getRegionStoreStats();
+		ImGui::Text("Chunks Loaded From Disk: %zu", store.loadedChunks);
+		ImGui::Text("Chunks Saved: %zu (%zu queued), %.2f MB", store.savedChunks, store.queuedSaves, store.bytesWritten / (1024.0 * 1024.0));
+		ImGui::Text("Open Regions: %zu, Compactions: %zu", store.openRegions, store.compactions);
+
+		ChunkIOStats io = world.getChunkIOStats();
+		ImGui::Text("Disk Reads: %zu chunks in %zu batches, %zu reads", io.chunksRead, io.readBatches, store.diskReads);
+		ImGui::Text("Read Requests: %zu, Retries: %zu", io.readRequests, io.readRetries);
+		ImGui::Text("Disk Read Rate: %.0f chunks/s", io.chunksReadPerSecond());
+		ImGui::Text("Disk Writes: %zu chunks in %zu batches, %zu retries", io.writes, io.writeBatches, io.writeRetries);
+	}
+
+	//// Rendering ////
+	ImGui::Separator();
+	if (ImGui::CollapsingHeader("Rendering", ImGuiTreeNodeFlags_DefaultOpen)) {
+		RenderSettings& renderSettings = world.getRenderSettings();
+		ImGui::Checkbox("Frustum Culling", &renderSettings.frustumCulling);
+		ImGui::Checkbox("Cave Culling", &renderSettings.caveCulling);
+		ImGui::Checkbox("Occlusion Culling", &renderSettings.occlusionCulling);
+
+		int maxOccluders = static_cast<int>(renderSettings.maxOccluders);
+		if (ImGui::SliderInt("Max Occluders", &maxOccluders, 0, 128))
+			renderSettings.maxOccluders = static_cast<size_t>(maxOccluders);
+
+		const RenderStats& renderStats = world.getRenderStats();
+		ImGui::Text("Chunk Draws: %zu of %zu in 1 multi-draw", renderStats.drawCount, renderStats.candidateCount);
+		ImGui::Text("Unreachable Chunks: %zu", renderStats.unreachableCount);
+		ImGui::Text("Occluded Chunks: %zu", renderStats.occludedCount);
+		ImGui::Text("Draw List Build: %lld us", static_cast<long long>(renderStats.drawListBuildTime.count()));
+	}
+
+	//// Mesh Arena ////
+	ImGui::Separator();
+	if (ImGui::CollapsingHeader("Mesh Arena")) {
+		MeshArenaStats arena = world.getMeshArena().getStats();
+		ImGui::Text("Meshes: %u", arena.meshCount);
+		ImGui::Text("Faces: %u / %u", arena.faces.used, arena.faces.capacity);
+		ImGui::Text("Free Blocks: %u", arena.faces.freeBlockCount);
+		ImGui::Text("Fragmentation: %.1f%%", arena.faces.fragmentation() * 100.0f);
+		ImGui::Text("Defragmentations: %u, Growths: %u", arena.defragmentations, arena.growths);
+		if (ImGui::Button("Defragment"))
+			world.getMeshArena().defragment();
+	}
+
 	if (ImGui::Button("Exit Game")) glfwSetWindowShouldClose(window, true);  // Close the game
 
 	ImGui::End();
@@ -217,8 +323,10 @@ void main::cleanupImGui()
 	ImGui::DestroyContext();
 }
 
-void main::cleanup(shader& mainShader)
+void main::cleanup(shader& mainShader, World& world)
 {
+	world.cleanupOpenGLResources();
+	frameUniforms.cleanupOpenGLResources();
 	mainShader.Delete();
 }
 
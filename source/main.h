@@ -15,6 +15,7 @@
 #include <gtx/string_cast.hpp>
 
 #include "shader.h"
+#include "UniformBuffer.h"
 #include "Camera.h"
 //#include "Chunk.h"
 #include "World.h"
@@ -32,9 +33,9 @@ public:
 	static void updateFPS();
 
 	static void initializeImGui(GLFWwindow* window);
-	static void renderImGui(GLFWwindow* window);
+	static void renderImGui(GLFWwindow* window, World& world);
 	static void cleanupImGui();
-	static void cleanup(shader& mainShader);
+	static void cleanup(shader& mainShader, World& world);
 	static void scroll_callback(GLFWwindow* window, GLdouble xoffset, GLdouble yoffset);
 	static void mouse_callback(GLFWwindow* window, GLdouble xposIn, GLdouble yposIn);
 	static void mouseButtonCallback(GLFWwindow* window, GLint button, GLint action, GLint mods);
@@ -4,6 +4,7 @@
 
 #include <glad/glad.h>
 
+#include <algorithm>
 #include <string>
 #include <fstream>
 #include <sstream>
@@ -11,7 +12,7 @@
 
 GLuint ID;
 
-shader::shader(const char* vertexPath, const char* fragmentPath)
+shader::shader(const char* vertexPath, const char* fragmentPath, const std::string& vertexPrelude)
 {
     std::string executableDir = getExecutableDir();
     std::string vertexFullPath = executableDir + "/shaders/" + vertexPath;
@@ -44,6 +45,13 @@ shader::shader(const char* vertexPath, const char* fragmentPath)
     {
         std::cout << "ERROR::SHADER::FILE_NOT_SUCCESSFULLY_READ: " << e.what() << std::endl;
     }
+    if (!vertexPrelude.empty())
+    {
+        // #version has to stay first, and #line keeps compile errors pointing at the file's lines
+        size_t versionEnd = vertexCode.find('\n');
+        if (versionEnd != std::string::npos)
+            vertexCode.insert(versionEnd + 1, vertexPrelude + "#line 2\n");
+    }
     const char* vShaderCode = vertexCode.c_str();
     const char* fShaderCode = fragmentCode.c_str();
     // 2. compile shaders
@@ -64,6 +72,7 @@ shader::shader(const char* vertexPath, const char* fragmentPath)
     glAttachShader(ID, fragment);
     glLinkProgram(ID);
     checkCompileErrors(ID, "PROGRAM");
+    reflectUniforms();
     // delete the shaders as they're linked into our program now and no longer necessary
     glDeleteShader(vertex);
     glDeleteShader(fragment);
@@ -84,19 +93,54 @@ void shader::Delete()
     glDeleteProgram(ID);
 }
 
+void shader::reflectUniforms()
+{
+    uniformLocations.clear();
+
+    GLint count = 0, maxLength = 0;
+    glGetProgramiv(ID, GL_ACTIVE_UNIFORMS, &count);
+    glGetProgramiv(ID, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength);
+
+    std::string name(std::max(maxLength, 1), '\0');
+    for (GLint i = 0; i < count; ++i)
+    {
+        GLsizei length = 0;
+        GLint size = 0;
+        GLenum type = 0;
+        glGetActiveUniform(ID, static_cast<GLuint>(i), maxLength, &length, &size, &type, name.data());
+        std::string uniformName = name.substr(0, length);
+
+        // Members of uniform blocks have no location, they are set through the buffer
+        GLint location = glGetUniformLocation(ID, uniformName.c_str());
+        if (location < 0)
+            continue;
+
+        // Arrays are reported as "name[0]", make them reachable by their plain name too
+        uniformLocations[uniformName] = location;
+        if (uniformName.size() > 3 && uniformName.compare(uniformName.size() - 3, 3, "[0]") == 0)
+            uniformLocations[uniformName.substr(0, uniformName.size() - 3)] = location;
+    }
+}
+
+UniformHandle shader::getUniform(const std::string& name) const
+{
+    auto it = uniformLocations.find(name);
+    return it != uniformLocations.end() ? it->second : INVALID_UNIFORM;
+}
+
 void shader::setBool(const std::string& name, bool value) const
 {
-    glUniform1i(glGetUniformLocation(ID, name.c_str()), (int)value);
+    glUniform1i(getUniform(name), (int)value);
 }
 
-void shader::setInt(const std::string& name, bool value) const
+void shader::setInt(const std::string& name, int value) const
 {
-    glUniform1i(glGetUniformLocation(ID, name.c_str()), value);
+    glUniform1i(getUniform(name), value);
 }
 
-void shader::setFloat(const std::string& name, bool value) const
+void shader::setFloat(const std::string& name, float value) const
 {
-    glUniform1f(glGetUniformLocation(ID, name.c_str()), value);
+    glUniform1f(getUniform(name), value);
 }
 
 void shader::checkCompileErrors(unsigned shader, std::string type)
@@ -125,47 +169,92 @@ void shader::checkCompileErrors(unsigned shader, std::string type)
 
 void shader::setVec2(const std::string& name, const glm::vec2& value) const
 {
-    glUniform2fv(glGetUniformLocation(ID, name.c_str()), 1, &value[0]);
+    glUniform2fv(getUniform(name), 1, &value[0]);
 }
 
 void shader::setVec2(const std::string& name, float x, float y) const
 {
-    glUniform2f(glGetUniformLocation(ID, name.c_str()), x, y);
+    glUniform2f(getUniform(name), x, y);
 }
 
 void shader::setVec3(const std::string& name, const glm::vec3& value) const
 {
-    glUniform3fv(glGetUniformLocation(ID, name.c_str()), 1, &value[0]);
+    glUniform3fv(getUniform(name), 1, &value[0]);
 }
 
 void shader::setVec3(const std::string& name, float x, float y, float z) const
 {
-    glUniform3f(glGetUniformLocation(ID, name.c_str()), x, y, z);
+    glUniform3f(getUniform(name), x, y, z);
 }
 
 void shader::setVec4(const std::string& name, const glm::vec4& value) const
 {
-    glUniform4fv(glGetUniformLocation(ID, name.c_str()), 1, &value[0]);
+    glUniform4fv(getUniform(name), 1, &value[0]);
 }
 
 void shader::setVec4(const std::string& name, float x, float y, float z, float w) const
 {
-    glUniform4f(glGetUniformLocation(ID, name.c_str()), x, y, z, w);
+    glUniform4f(getUniform(name), x, y, z, w);
 }
 
 void shader::setMat2(const std::string& name, const glm::mat2& mat) const
 {
-    glUniformMatrix2fv(glGetUniformLocation(ID, name.c_str()), 1, GL_FALSE, &mat[0][0]);
+    glUniformMatrix2fv(getUniform(name), 1, GL_FALSE, &mat[0][0]);
 }
 
 void shader::setMat3(const std::string& name, const glm::mat3& mat) const
 {
-    glUniformMatrix3fv(glGetUniformLocation(ID, name.c_str()), 1, GL_FALSE, &mat[0][0]);
+    glUniformMatrix3fv(getUniform(name), 1, GL_FALSE, &mat[0][0]);
 }
 
 void shader::setMat4(const std::string& name, const glm::mat4& mat) const
 {
-    glUniformMatrix4fv(glGetUniformLocation(ID, name.c_str()), 1, GL_FALSE, &mat[0][0]);
+    glUniformMatrix4fv(getUniform(name), 1, GL_FALSE, &mat[0][0]);
+}
+
+void shader::setBool(UniformHandle location, bool value) const
+{
+    glUniform1i(location, (int)value);
+}
+
+void shader::setInt(UniformHandle location, int value) const
+{
+    glUniform1i(location, value);
+}
+
+void shader::setFloat(UniformHandle location, float value) const
+{
+    glUniform1f(location, value);
+}
+
+void shader::setVec2(UniformHandle location, const glm::vec2& value) const
+{
+    glUniform2fv(location, 1, &value[0]);
+}
+
+void shader::setVec3(UniformHandle location, const glm::vec3& value) const
+{
+    glUniform3fv(location, 1, &value[0]);
+}
+
+void shader::setVec4(UniformHandle location, const glm::vec4& value) const
+{
+    glUniform4fv(location, 1, &value[0]);
+}
+
+void shader::setMat2(UniformHandle location, const glm::mat2& mat) const
+{
+    glUniformMatrix2fv(location, 1, GL_FALSE, &mat[0][0]);
+}
+
+void shader::setMat3(UniformHandle location, const glm::mat3& mat) const
+{
+    glUniformMatrix3fv(location, 1, GL_FALSE, &mat[0][0]);
+}
+
+void shader::setMat4(UniformHandle location, const glm::mat4& mat) const
+{
+    glUniformMatrix4fv(location, 1, GL_FALSE, &mat[0][0]);
 }
 
 std::string shader::getExecutableDir()
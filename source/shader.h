@@ -13,21 +13,31 @@
 #include <sstream>
 #include <iostream>
 #include <filesystem>
+#include <unordered_map>
+
+// Location of an active uniform, looked up once with shader::getUniform
+using UniformHandle = GLint;
+constexpr UniformHandle INVALID_UNIFORM = -1;
 
 class shader
 {
 public:
 	unsigned ID;
 
-	shader(const char* vertexPath, const char* fragmentPath);
+	// vertexPrelude is inserted right after the vertex shader's #version line, for
+	// declarations generated on the C++ side
+	shader(const char* vertexPath, const char* fragmentPath, const std::string& vertexPrelude = "");
     ~shader();
 
 	void use(); 
     void Delete();
 
+	// Cached at link time, INVALID_UNIFORM for names that are not active uniforms
+	UniformHandle getUniform(const std::string& name) const;
+
 	void setBool(const std::string& name, bool value) const;
-	void setInt(const std::string& name, bool value) const;
-	void setFloat(const std::string& name, bool value) const;
+	void setInt(const std::string& name, int value) const;
+	void setFloat(const std::string& name, float value) const;
 
 	void checkCompileErrors(unsigned shader, std::string type);
 
@@ -48,8 +58,24 @@ public:
     void setMat3(const std::string& name, const glm::mat3& mat) const;
 
     void setMat4(const std::string& name, const glm::mat4& mat) const;
+
+    // Handle-based setters, no lookup at all
+    void setBool(UniformHandle location, bool value) const;
+    void setInt(UniformHandle location, int value) const;
+    void setFloat(UniformHandle location, float value) const;
+    void setVec2(UniformHandle location, const glm::vec2& value) const;
+    void setVec3(UniformHandle location, const glm::vec3& value) const;
+    void setVec4(UniformHandle location, const glm::vec4& value) const;
+    void setMat2(UniformHandle location, const glm::mat2& mat) const;
+    void setMat3(UniformHandle location, const glm::mat3& mat) const;
+    void setMat4(UniformHandle location, const glm::mat4& mat) const;
     
     std::string getExecutableDir();
+
+private:
+    void reflectUniforms();
+
+    std::unordered_map<std::string, UniformHandle> uniformLocations;
 };
 
 #endif
\ No newline at end of file
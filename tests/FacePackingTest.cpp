@@ -0,0 +1,65 @@
+// Checks packFace/unpackFace against the float FACE_DATA tables the old per-vertex format
+// was built from. main.vs gets its tables from faceTablesGLSL(), so this covers the shader too.
+// Build: g++ -std=c++17 -Isource -Ithirdparty/include -Ithirdparty/include/glm -Ithirdparty/include/glad/include tests/FacePackingTest.cpp source/Block.cpp -o FacePackingTest
+#include "Block.h"
+#include "ChunkStorage.h"
+#include <iostream>
+
+int main() {
+    // The fields are independent, so values at the edges of each bit field plus one in
+    // between cover them
+    const int xz[] = { 0, 5, CHUNK_SIZE - 1 };
+    const int ys[] = { 0, 37, CHUNK_HEIGHT - 1 };
+    const int sizes[] = { 1, 2, CHUNK_SIZE };
+    const int heights[] = { 1, 7, CHUNK_HEIGHT };
+
+    int failures = 0;
+    for (int faceIndex = 0; faceIndex < 6; faceIndex++) {
+        Face face = static_cast<Face>(faceIndex);
+        const GLfloat* faceData = FACE_DATA[faceIndex];
+        const int8_t* uvAxes = FACE_UV_AXES[faceIndex];
+
+        for (int x : xz)
+        for (int y : ys)
+        for (int z : xz)
+        for (int width : sizes)
+        for (int height : heights) {
+            glm::ivec3 pos(x, y, z);
+            glm::vec3 size(1.0f);
+            size[uvAxes[0]] = static_cast<float>(width);
+            size[uvAxes[1]] = static_cast<float>(height);
+
+            FaceVertex corners[4];
+            unpackFace(packFace(pos, face, glm::ivec2(width, height), BlockType::SOLID), corners);
+
+            // The old path: FACE_DATA corners shifted to [0, 1] and scaled by the quad size
+            for (int i = 0; i < 4; i++) {
+                glm::vec3 position = glm::vec3(pos) + (glm::vec3(faceData[i * 8 + 0], faceData[i * 8 + 1], faceData[i * 8 + 2]) + 0.5f) * size;
+                glm::vec3 normal(faceData[i * 8 + 3], faceData[i * 8 + 4], faceData[i * 8 + 5]);
+                glm::vec2 texCoord = glm::vec2(faceData[i * 8 + 6], faceData[i * 8 + 7]) * glm::vec2(width, height);
+
+                if (corners[i].position != position || corners[i].normal != normal || corners[i].texCoord != texCoord) {
+                    if (failures++ < 10)
+                        std::cerr << "Face " << faceIndex << " at (" << x << ", " << y << ", " << z << ") size "
+                                  << width << "x" << height << ": corner " << i << " does not match FACE_DATA" << std::endl;
+                }
+            }
+        }
+    }
+
+    // Every table main.vs relies on has to be in the generated block
+    std::string glsl = faceTablesGLSL();
+    for (const char* table : { "FACE_CORNERS[24]", "FACE_UVS[24]", "FACE_NORMALS[6]", "FACE_UV_AXES[6]", "QUAD_CORNERS[6]" }) {
+        if (glsl.find(table) == std::string::npos) {
+            std::cerr << "faceTablesGLSL() does not declare " << table << std::endl;
+            failures++;
+        }
+    }
+
+    if (failures) {
+        std::cerr << failures << " face packing checks failed" << std::endl;
+        return 1;
+    }
+    std::cout << "Face packing matches FACE_DATA" << std::endl;
+    return 0;
+}
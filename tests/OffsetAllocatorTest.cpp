@@ -0,0 +1,110 @@
+// Randomised allocate/free/grow/defragment against a brute-force occupancy map of every unit.
+// Build: g++ -std=c++17 -Isource tests/OffsetAllocatorTest.cpp source/OffsetAllocator.cpp -o OffsetAllocatorTest
+#include "OffsetAllocator.h"
+#include <iostream>
+#include <map>
+#include <random>
+#include <vector>
+
+static constexpr int OPERATIONS = 200000;
+static constexpr uint32_t INITIAL_CAPACITY = 100000;
+static constexpr uint32_t MAX_CAPACITY = 200000;
+static constexpr uint32_t MAX_SIZE = 2000;
+static constexpr uint32_t TARGET_FILL = 90;                // Percent of capacity
+
+struct Allocation {
+    uint32_t offset;
+    uint32_t size;
+};
+
+static int failures = 0;
+
+static void check(bool condition, const char* what, int operation) {
+    if (!condition && failures++ < 10)
+        std::cerr << "Operation " << operation << ": " << what << std::endl;
+}
+
+// Marks the range as owned, false if any unit of it already was
+static bool claim(std::vector<uint8_t>& occupied, const Allocation& allocation) {
+    bool free = true;
+    for (uint32_t i = 0; i < allocation.size; ++i) {
+        free = free && !occupied[allocation.offset + i];
+        occupied[allocation.offset + i] = 1;
+    }
+    return free;
+}
+
+int main() {
+    std::mt19937 rng(1);
+    OffsetAllocator allocator(INITIAL_CAPACITY);
+    std::vector<uint8_t> occupied(MAX_CAPACITY, 0);
+    std::vector<Allocation> live;
+
+    for (int operation = 0; operation < OPERATIONS; ++operation) {
+        // Mostly allocations below TARGET_FILL and mostly frees above it, so the allocator
+        // hovers near full and large allocations regularly fail on fragmented space
+        AllocatorStats stats = allocator.getStats();
+        bool belowTarget = stats.used < static_cast<uint64_t>(stats.capacity) * TARGET_FILL / 100;
+        if (rng() % 100 < (belowTarget ? 70u : 30u)) {
+            uint32_t size = 1 + rng() % MAX_SIZE;
+            uint32_t offset = allocator.allocate(size);
+            if (offset != OffsetAllocator::INVALID_OFFSET) {
+                check(offset + size <= allocator.getCapacity(), "allocation past the end", operation);
+                check(claim(occupied, { offset, size }), "allocation overlaps a live one", operation);
+                live.push_back({ offset, size });
+                continue;
+            }
+
+            // Out of space: sometimes grow, otherwise defragment if that would help
+            if (rng() % 4 == 0 && allocator.getCapacity() + 5000 <= MAX_CAPACITY) {
+                allocator.grow(allocator.getCapacity() + 5000);
+            }
+            else if (stats.largestFreeBlock < stats.capacity - stats.used && rng() % 3 == 0) {
+                std::map<uint32_t, AllocatorMove> moves;
+                for (const AllocatorMove& move : allocator.defragment())
+                    moves[move.from] = move;
+                std::fill(occupied.begin(), occupied.end(), 0);
+                for (Allocation& allocation : live) {
+                    auto move = moves.find(allocation.offset);
+                    if (move != moves.end()) {
+                        check(move->second.size == allocation.size, "move size differs from the allocation", operation);
+                        allocation.offset = move->second.to;
+                    }
+                    check(claim(occupied, allocation), "defragment made allocations overlap", operation);
+                    check(allocator.sizeOf(allocation.offset) == allocation.size, "allocation lost by defragment", operation);
+                }
+                check(allocator.getStats().freeBlockCount <= 1, "free space not merged after defragment", operation);
+            }
+        }
+        else if (!live.empty()) {
+            size_t index = rng() % live.size();
+            Allocation allocation = live[index];
+            check(allocator.sizeOf(allocation.offset) == allocation.size, "sizeOf differs from the allocation", operation);
+            allocator.free(allocation.offset);
+            for (uint32_t i = 0; i < allocation.size; ++i)
+                occupied[allocation.offset + i] = 0;
+            live[index] = live.back();
+            live.pop_back();
+        }
+    }
+
+    AllocatorStats stats = allocator.getStats();
+    uint64_t used = 0;
+    for (const Allocation& allocation : live)
+        used += allocation.size;
+    check(used == stats.used, "used space differs from the live allocations", OPERATIONS);
+    check(stats.allocationCount == live.size(), "allocation count differs", OPERATIONS);
+
+    // Freeing everything has to merge back into a single block
+    for (const Allocation& allocation : live)
+        allocator.free(allocation.offset);
+    stats = allocator.getStats();
+    check(stats.freeBlockCount == 1 && stats.largestFreeBlock == stats.capacity, "free blocks not merged after freeing everything", OPERATIONS);
+
+    if (failures) {
+        std::cerr << failures << " allocator checks failed" << std::endl;
+        return 1;
+    }
+    std::cout << "OffsetAllocator matches the occupancy map, capacity " << stats.capacity << std::endl;
+    return 0;
+}